@@ -0,0 +1,51 @@
+#include "HeadlessContext.h"
+#include <cstddef>
+
+#ifdef MOLTEN_OSMESA
+#include <GL/osmesa.h>
+#endif
+
+HeadlessContext::HeadlessContext() : context(nullptr), width(0), height(0) {}
+
+HeadlessContext::~HeadlessContext() {
+	destroy();
+}
+
+bool HeadlessContext::isAvailable() {
+#ifdef MOLTEN_OSMESA
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool HeadlessContext::create(int w, int h) {
+	destroy();
+#ifdef MOLTEN_OSMESA
+	OSMesaContext ctx = OSMesaCreateContextExt(OSMESA_RGBA, 0, 0, 0, nullptr);
+	if (!ctx) return false;
+	pixels.assign((size_t)w * h * 4, 0);
+	if (!OSMesaMakeCurrent(ctx, pixels.data(), GL_UNSIGNED_BYTE, w, h)) {
+		OSMesaDestroyContext(ctx);
+		return false;
+	}
+	context = ctx;
+	width = w;
+	height = h;
+	return true;
+#else
+	(void)w;
+	(void)h;
+	return false;
+#endif
+}
+
+void HeadlessContext::destroy() {
+#ifdef MOLTEN_OSMESA
+	if (context) OSMesaDestroyContext((OSMesaContext)context);
+#endif
+	context = nullptr;
+	pixels.clear();
+	width = 0;
+	height = 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <vector>
+
+// Offscreen software GL context for rendering without a window or display server.
+// Needs OSMesa (Mesa's llvmpipe/softpipe); compile with MOLTEN_OSMESA and link -lOSMesa.
+// Without it create() always fails.
+class HeadlessContext {
+private:
+	void* context;
+	std::vector<unsigned char> pixels;
+	int width;
+	int height;
+
+public:
+	HeadlessContext();
+	~HeadlessContext();
+	HeadlessContext(const HeadlessContext&) = delete;
+	HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+	// Creates an RGBA context of the given size and makes it current on the calling thread
+	bool create(int w, int h);
+	void destroy();
+
+	static bool isAvailable();
+};
@@ -0,0 +1,384 @@
+// molten-bench: end-to-end scenario driver.
+//
+//   molten-bench [--scenario NAME] [--ticks N] [--seed N] [--out FILE] [--threads N] [--render]
+//                [--assert-no-alloc-after TICK] [--check-determinism] [--list]
+//
+// Each scenario runs the full Game::update loop for a fixed number of ticks
+// with a fixed seed and scripted input, then reports ticks/second, per-tick
+// time percentiles, peak entity counts and peak RSS as JSON. Without
+// --scenario every scenario runs in turn.
+//
+// --threads sets the job system's worker count (default: one per spare core,
+// 0 runs every pass on the simulation thread). Results are identical either way.
+//
+// --render also draws every tick into an offscreen OSMesa context as fast as
+// possible and reports frames/second and CPU time per frame, so render-path
+// regressions show up on machines with no display. It needs a build with
+// MOLTEN_OSMESA and -lOSMesa, e.g. on Linux from this directory:
+//   g++ -O2 -std=c++17 -pthread -DMOLTEN_OSMESA -I../OpenGL2DTemplate -o molten-bench MoltenBench.cpp HeadlessContext.cpp
+//       $(ls ../OpenGL2DTemplate/*.cpp | grep -v main.cpp) -lOSMesa -lglut -lGLU -lGL
+//
+// --assert-no-alloc-after counts every heap allocation from TICK onwards, on any
+// thread, reports them per subsystem and exits with status 3 if there were any,
+// listing the busiest callers on stderr. Each tick also copies a render snapshot into
+// a triple buffer, as the pipelined game loop does, so that copy is covered too. It
+// needs a build with MOLTEN_ALLOC_STATS (on in Debug, or add -DMOLTEN_ALLOC_STATS=1).
+//
+// Every scenario reports a state_hash over its entity counts and player position
+// after each tick. --check-determinism runs each scenario a second time with the
+// same seed and exits with status 4 if the two hashes differ.
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <memory>
+#include "Game.h"
+#include "HeadlessContext.h"
+#include "JobSystem.h"
+#include "AllocStats.h"
+#include "TripleBuffer.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+static const float BENCH_DT = 1.0f / 60.0f;
+
+struct GameBenchAccess {
+	// Scenarios measure a steady workload, so the run never ends early
+	static void keepAlive(Game& game) {
+		game.lives = 3;
+		game.state = GameState::Playing;
+	}
+
+	static void scatterGems(Game& game, int count, float bottom, float top) {
+		std::mt19937 rng(4321);
+		std::uniform_real_distribution<float> x(40.0f, game.screenW - 40.0f);
+		std::uniform_real_distribution<float> y(bottom, top);
+		game.world.reserve<Collectable, CollectableAnimation>(game.world.count<Collectable>() + count);
+		for (int i = 0; i < count; ++i) game.world.create(Collectable(x(rng), y(rng)), CollectableAnimation());
+	}
+
+	static size_t rockCount(const Game& game) { return game.world.count<Rock>(); }
+	static size_t gemCount(const Game& game) { return game.world.count<Collectable>(); }
+	static size_t powerupCount(const Game& game) { return game.world.count<PowerUp>(); }
+	static size_t platformCount(const Game& game) { return game.world.count<Platform>(); }
+	static float playerX(const Game& game) { return game.player.getX(); }
+	static float playerY(const Game& game) { return game.player.getY(); }
+};
+
+struct Scenario {
+	const char* name;
+	const char* description;
+	GameMode mode;
+	void (*setup)(Game& game);
+};
+
+static void setupRockStorm(Game& game) {
+	Tuning t = game.getTuning();
+	t.rockSpawnMin = 0.0f;  // a rock every tick
+	t.rockSpawnMax = 0.0f;
+	t.rockFallSpeed = 60.0f;
+	game.setTuning(t);
+}
+
+static void setupRockStorm100k(Game& game) {
+	// Rocks live about five seconds between spawning and reaching the lava
+	game.setRockStorm(20000.0f);
+}
+
+static void setupDenseGemField(Game& game) {
+	GameBenchAccess::scatterGems(game, 50000, 100.0f, 2400.0f);
+}
+
+static void setupLongLavaClimb(Game& game) {
+	Tuning t = game.getTuning();
+	t.lavaAccel = 1.5f;
+	game.setTuning(t);
+}
+
+static void setupLavaFlow(Game& game) {
+	Tuning t = game.getTuning();
+	t.lavaAccel = 1.5f;
+	game.setTuning(t);
+	game.setLavaFlow(true);
+}
+
+static void setupPowerUpSpam(Game& game) {
+	Tuning t = game.getTuning();
+	t.powerupSpawnMin = 0.0f;
+	t.powerupSpawnMax = 0.05f;
+	game.setTuning(t);
+}
+
+static const Scenario SCENARIOS[] = {
+	{ "rock-storm", "one rock spawned per tick", GameMode::Classic, setupRockStorm },
+	{ "rock-storm-100k", "stress mode with over 100k rocks in the air", GameMode::Classic, setupRockStorm100k },
+	{ "dense-gem-field", "50k gems over the classic level", GameMode::Classic, setupDenseGemField },
+	{ "long-lava-climb", "endless mode with fast lava, chunk streaming and freeing", GameMode::Endless, setupLongLavaClimb },
+	{ "lava-flow", "classic level with grid-simulated lava climbing around the platforms", GameMode::Classic, setupLavaFlow },
+	{ "powerup-spam", "a power-up every few ticks", GameMode::Classic, setupPowerUpSpam },
+};
+
+// Deterministic input: strafe left and right in 1.5 s swings, jump twice a second
+static void scriptInput(Game& game, int tick) {
+	int phase = (tick / 90) % 2;
+	if (tick % 90 == 0) {
+		game.onKeyUp(phase ? 'a' : 'd');
+		game.onKeyDown(phase ? 'd' : 'a');
+	}
+	if (tick % 30 == 0) game.onKeyDown('w');
+}
+
+static long long peakRssKb() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+	return (long long)(counters.PeakWorkingSetSize / 1024);
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+	return (long long)usage.ru_maxrss; // kilobytes on Linux
+#endif
+}
+
+// User + kernel time of the whole process, so llvmpipe's worker threads are included
+static double processCpuSeconds() {
+#ifdef _WIN32
+	FILETIME created, exited, kernel, user;
+	if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0.0;
+	ULARGE_INTEGER k, u;
+	k.LowPart = kernel.dwLowDateTime; k.HighPart = kernel.dwHighDateTime;
+	u.LowPart = user.dwLowDateTime; u.HighPart = user.dwHighDateTime;
+	return (k.QuadPart + u.QuadPart) * 1.0e-7;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+	return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1.0e-6;
+#endif
+}
+
+static void setupProjection(int w, int h) {
+	glViewport(0, 0, w, h);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	gluOrtho2D(0.0, w, 0.0, h);
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+}
+
+// FNV-1a, folded over the per-tick state so any divergence between runs shows up
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 1099511628211ull;
+	return hash;
+}
+
+static uint64_t hashTick(uint64_t hash, const Game& game) {
+	uint64_t counts[4] = { GameBenchAccess::rockCount(game), GameBenchAccess::gemCount(game), GameBenchAccess::powerupCount(game), GameBenchAccess::platformCount(game) };
+	float position[2] = { GameBenchAccess::playerX(game), GameBenchAccess::playerY(game) };
+	hash = hashBytes(hash, counts, sizeof(counts));
+	return hashBytes(hash, position, sizeof(position));
+}
+
+static double percentile(std::vector<double>& sorted, double p) {
+	if (sorted.empty()) return 0.0;
+	size_t k = (size_t)(p * (sorted.size() - 1) + 0.5);
+	return sorted[k];
+}
+
+struct ScenarioResult {
+	bool allocFree; // false if allocations were asserted against and some happened
+	uint64_t stateHash;
+};
+
+static ScenarioResult runScenario(const Scenario& scenario, int ticks, unsigned seed, bool render, int noAllocAfter, FILE* out, bool first) {
+	Game game(800, 600, 4, scenario.mode, seed);
+	scenario.setup(game);
+	if (render) {
+		game.setHudVisible(false);
+		setupProjection(800, 600);
+	}
+
+	std::vector<double> tickMs;
+	std::vector<double> frameMs;
+	tickMs.reserve(ticks);
+	if (render) frameMs.reserve(ticks);
+	double renderSeconds = 0.0;
+	double renderCpuSeconds = 0.0;
+	size_t peakRocks = 0, peakGems = 0, peakPowerups = 0, peakPlatforms = 0;
+	bool checkAllocs = noAllocAfter >= 0 && noAllocAfter < ticks;
+	std::unique_ptr<TripleBuffer<RenderSnapshot>> snapshots;
+	if (checkAllocs) snapshots.reset(new TripleBuffer<RenderSnapshot>(game.snapshot()));
+	uint64_t stateHash = 14695981039346656037ull;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int tick = 0; tick < ticks; ++tick) {
+		if (tick == noAllocAfter) AllocStats::endFrame(); // everything before this is warm-up
+		scriptInput(game, tick);
+		GameBenchAccess::keepAlive(game);
+
+		auto tickStart = std::chrono::steady_clock::now();
+		game.update(BENCH_DT);
+		auto tickEnd = std::chrono::steady_clock::now();
+		tickMs.push_back(std::chrono::duration<double, std::milli>(tickEnd - tickStart).count());
+		if (snapshots) {
+			game.captureSnapshot(snapshots->getBack());
+			snapshots->publish();
+			snapshots->acquire();
+		}
+
+		if (render) {
+			double cpuStart = processCpuSeconds();
+			auto frameStart = std::chrono::steady_clock::now();
+			glClear(GL_COLOR_BUFFER_BIT);
+			game.render();
+			glFinish(); // count the rasterisation, not just command submission
+			auto frameEnd = std::chrono::steady_clock::now();
+			renderCpuSeconds += processCpuSeconds() - cpuStart;
+			double ms = std::chrono::duration<double, std::milli>(frameEnd - frameStart).count();
+			renderSeconds += ms / 1000.0;
+			frameMs.push_back(ms);
+		}
+
+		peakRocks = std::max(peakRocks, GameBenchAccess::rockCount(game));
+		peakGems = std::max(peakGems, GameBenchAccess::gemCount(game));
+		peakPowerups = std::max(peakPowerups, GameBenchAccess::powerupCount(game));
+		peakPlatforms = std::max(peakPlatforms, GameBenchAccess::platformCount(game));
+		stateHash = hashTick(stateHash, game);
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (checkAllocs) AllocStats::endFrame();
+
+	std::sort(tickMs.begin(), tickMs.end());
+	std::sort(frameMs.begin(), frameMs.end());
+	fprintf(out,
+		"%s    {\n"
+		"      \"name\": \"%s\",\n"
+		"      \"description\": \"%s\",\n"
+		"      \"ticks\": %d,\n"
+		"      \"seed\": %u,\n"
+		"      \"seconds\": %.6f,\n"
+		"      \"ticks_per_second\": %.1f,\n"
+		"      \"tick_ms\": { \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n"
+		"      \"peak_entities\": { \"rocks\": %zu, \"gems\": %zu, \"powerups\": %zu, \"platforms\": %zu },\n"
+		"      \"state_hash\": \"%016llx\",\n"
+		"      \"peak_rss_kb\": %lld",
+		first ? "" : ",\n", scenario.name, scenario.description, ticks, seed, seconds, ticks / seconds,
+		percentile(tickMs, 0.50), percentile(tickMs, 0.90), percentile(tickMs, 0.99), tickMs.empty() ? 0.0 : tickMs.back(),
+		peakRocks, peakGems, peakPowerups, peakPlatforms, (unsigned long long)stateHash, peakRssKb());
+	if (render) {
+		fprintf(out,
+			",\n      \"render\": { \"frames_per_second\": %.1f, \"cpu_ms_per_frame\": %.4f, "
+			"\"frame_ms\": { \"p50\": %.4f, \"p99\": %.4f, \"max\": %.4f } }",
+			ticks / renderSeconds, renderCpuSeconds * 1000.0 / ticks,
+			percentile(frameMs, 0.50), percentile(frameMs, 0.99), frameMs.empty() ? 0.0 : frameMs.back());
+	}
+
+	uint64_t allocs = 0;
+	if (checkAllocs) {
+		fprintf(out, ",\n      \"allocations_after_warmup\": { \"from_tick\": %d", noAllocAfter);
+		for (int i = 0; i < (int)AllocCategory::Count; ++i) {
+			const AllocCounters& c = AllocStats::getLastFrame((AllocCategory)i);
+			fprintf(out, ", \"%s\": [%llu, %llu]", AllocStats::getCategoryName((AllocCategory)i), (unsigned long long)c.count, (unsigned long long)c.bytes);
+			allocs += c.count;
+		}
+		fprintf(out, " }");
+	}
+	fprintf(out, "\n    }");
+
+	if (allocs > 0) {
+		AllocSite sites[8];
+		int count = AllocStats::getLastFrameSites(sites, 8);
+		fprintf(stderr, "%s: %llu allocations after tick %d\n", scenario.name, (unsigned long long)allocs, noAllocAfter);
+		for (int i = 0; i < count; ++i) {
+			fprintf(stderr, "  %p  %llu allocations, %llu bytes\n", sites[i].caller, (unsigned long long)sites[i].count, (unsigned long long)sites[i].bytes);
+		}
+	}
+	return { allocs == 0, stateHash };
+}
+
+int main(int argc, char** argv) {
+	const char* only = nullptr;
+	const char* outPath = nullptr;
+	int ticks = 20000;
+	unsigned seed = 1;
+	bool render = false;
+	int threads = -1;
+	int noAllocAfter = -1;
+	bool checkDeterminism = false;
+
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) only = argv[++i];
+		else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) ticks = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = (unsigned)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) outPath = argv[++i];
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--render") == 0) render = true;
+		else if (strcmp(argv[i], "--assert-no-alloc-after") == 0 && i + 1 < argc) noAllocAfter = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--check-determinism") == 0) checkDeterminism = true;
+		else if (strcmp(argv[i], "--list") == 0) {
+			for (const auto& s : SCENARIOS) printf("%-18s %s\n", s.name, s.description);
+			return 0;
+		}
+		else {
+			fprintf(stderr, "unknown argument: %s\n", argv[i]);
+			return 2;
+		}
+	}
+
+	if (noAllocAfter >= 0 && !AllocStats::isEnabled()) {
+		fprintf(stderr, "built without MOLTEN_ALLOC_STATS; --assert-no-alloc-after is unavailable\n");
+		return 1;
+	}
+
+	HeadlessContext context;
+	if (render && !context.create(800, 600)) {
+		fprintf(stderr, HeadlessContext::isAvailable() ? "could not create an OSMesa context\n" : "built without MOLTEN_OSMESA; --render is unavailable\n");
+		return 1;
+	}
+
+	FILE* out = outPath ? fopen(outPath, "w") : stdout;
+	if (!out) {
+		fprintf(stderr, "cannot open %s\n", outPath);
+		return 1;
+	}
+
+	JobSystem::init(threads);
+	fprintf(out, "{\n  \"threads\": %d,\n  \"scenarios\": [\n", JobSystem::getWorkerCount() + 1);
+	bool first = true;
+	bool allocFree = true;
+	bool deterministic = true;
+	for (const auto& s : SCENARIOS) {
+		if (only && strcmp(only, s.name) != 0) continue;
+		ScenarioResult result = runScenario(s, ticks, seed, render, noAllocAfter, out, first);
+		allocFree &= result.allocFree;
+		first = false;
+		if (checkDeterminism) {
+			ScenarioResult again = runScenario(s, ticks, seed, render, noAllocAfter, out, first);
+			allocFree &= again.allocFree;
+			if (again.stateHash != result.stateHash) {
+				fprintf(stderr, "%s: state differs between two runs with seed %u\n", s.name, seed);
+				deterministic = false;
+			}
+		}
+	}
+	fprintf(out, "\n  ]\n}\n");
+	if (out != stdout) fclose(out);
+	JobSystem::shutdown();
+
+	if (first) {
+		fprintf(stderr, "no scenario named %s (see --list)\n", only);
+		return 1;
+	}
+	if (!deterministic) return 4;
+	return allocFree ? 0 : 3;
+}
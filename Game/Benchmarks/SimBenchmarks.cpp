@@ -0,0 +1,149 @@
+// Microbenchmarks for the simulation hot paths.
+//
+//   SimBenchmarks --benchmark_format=json --benchmark_out=baseline.json
+//   SimBenchmarks --benchmark_filter=CheckCollisions
+//
+// Entity counts run from 10 to 1M in powers of ten. The player is parked far
+// away from every entity so no pass ever ends the run.
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <random>
+#include "Game.h"
+
+static const float BENCH_DT = 1.0f / 60.0f;
+
+struct GameBenchAccess {
+	static void populate(Game& game, int count) {
+		std::mt19937 rng(1234);
+		std::uniform_real_distribution<float> x(40.0f, 760.0f);
+		std::uniform_real_distribution<float> y(1.0e6f, 2.0e6f);
+
+		game.world.destroyAll<Rock>();
+		game.world.destroyAll<Collectable>();
+		game.world.destroyAll<PowerUp>();
+		game.world.reserve<Rock>(count);
+		game.world.reserve<Collectable, CollectableAnimation>(count);
+		game.world.reserve<PowerUp, PowerUpAnimation>(count);
+		for (int i = 0; i < count; ++i) {
+			game.world.create(Rock(x(rng), y(rng), 40.0f, 28.0f));
+			PowerUpType type = i % 2 ? PowerUpType::SHIELD : PowerUpType::SPEED_BOOST;
+			game.world.create(Collectable(x(rng), y(rng)), CollectableAnimation());
+			game.world.create(PowerUp(type, x(rng), y(rng)), PowerUpAnimation(type));
+		}
+		game.player.setPosition(-1.0e5f, 1.0e7f);
+		game.freeSwallowedEntities(); // sorts the new tables by height, as a level's first tick would
+	}
+
+	static void checkCollisions(Game& game) { game.checkCollisions(); game.resolveEvents(BENCH_DT); }
+	static void freeSwallowedEntities(Game& game) { game.freeSwallowedEntities(); }
+	static void spawnRock(Game& game) { game.spawnRock(); }
+	static void releaseRocks(Game& game) { game.resetWorld(); }
+	static size_t rockCount(const Game& game) { return game.world.count<Rock>(); }
+};
+
+static void BM_CheckCollisions(benchmark::State& state) {
+	Game game(800, 600, 4, GameMode::Classic, 1);
+	GameBenchAccess::populate(game, (int)state.range(0));
+	for (auto _ : state) {
+		GameBenchAccess::checkCollisions(game);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0) * 3);
+}
+BENCHMARK(BM_CheckCollisions)->RangeMultiplier(10)->Range(10, 1000000);
+
+static void BM_GameUpdate(benchmark::State& state) {
+	Game game(800, 600, 4, GameMode::Classic, 1);
+	GameBenchAccess::populate(game, (int)state.range(0));
+	for (auto _ : state) {
+		game.update(BENCH_DT);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0) * 3);
+}
+BENCHMARK(BM_GameUpdate)->RangeMultiplier(10)->Range(10, 1000000);
+
+// The lava pass with nothing under the lava: entities are kept sorted by height,
+// so this should stay flat as N grows
+static void BM_FreeSwallowedEntities(benchmark::State& state) {
+	Game game(800, 600, 4, GameMode::Classic, 1);
+	GameBenchAccess::populate(game, (int)state.range(0));
+	for (auto _ : state) {
+		GameBenchAccess::freeSwallowedEntities(game);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0) * 3);
+}
+BENCHMARK(BM_FreeSwallowedEntities)->RangeMultiplier(10)->Range(10, 1000000);
+
+static void BM_PlatformIsPlayerOnTop(benchmark::State& state) {
+	std::mt19937 rng(99);
+	std::uniform_real_distribution<float> x(0.0f, 800.0f);
+	std::uniform_real_distribution<float> y(0.0f, 1.0e5f);
+	std::vector<Platform> platforms;
+	platforms.reserve(state.range(0));
+	for (int64_t i = 0; i < state.range(0); ++i) platforms.emplace_back(x(rng), y(rng), 120.0f, 20.0f);
+
+	for (auto _ : state) {
+		bool grounded = false;
+		for (const auto& p : platforms) grounded |= p.isPlayerOnTop(400.0f, 5.0e4f, 20.0f, 85.0f);
+		benchmark::DoNotOptimize(grounded);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PlatformIsPlayerOnTop)->RangeMultiplier(10)->Range(10, 1000000);
+
+static void BM_CollectableIsColliding(benchmark::State& state) {
+	std::mt19937 rng(77);
+	std::uniform_real_distribution<float> x(0.0f, 800.0f);
+	std::uniform_real_distribution<float> y(0.0f, 1.0e5f);
+	std::vector<Collectable> collectables;
+	collectables.reserve(state.range(0));
+	for (int64_t i = 0; i < state.range(0); ++i) collectables.emplace_back(x(rng), y(rng));
+
+	for (auto _ : state) {
+		int hits = 0;
+		for (const auto& c : collectables) hits += c.isColliding(400.0f, 5.0e4f, 12.0f);
+		benchmark::DoNotOptimize(hits);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CollectableIsColliding)->RangeMultiplier(10)->Range(10, 1000000);
+
+// Lava is a single object; the argument is the number of ticks per iteration
+static void BM_LavaUpdate(benchmark::State& state) {
+	Lava lava(800.0f, 0.0f, 1.0f);
+	lava.setGrowthRate(6.0f);
+	for (auto _ : state) {
+		for (int64_t i = 0; i < state.range(0); ++i) lava.update(BENCH_DT);
+		benchmark::DoNotOptimize(lava.getTopY());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LavaUpdate)->RangeMultiplier(10)->Range(10, 1000000);
+
+// Spawning N rocks into a freshly reset level, including the rock table's growth past its reserve
+static void BM_SpawnRock(benchmark::State& state) {
+	Game game(800, 600, 4, GameMode::Classic, 1);
+	for (auto _ : state) {
+		state.PauseTiming();
+		GameBenchAccess::releaseRocks(game);
+		state.ResumeTiming();
+		for (int64_t i = 0; i < state.range(0); ++i) GameBenchAccess::spawnRock(game);
+		benchmark::DoNotOptimize(GameBenchAccess::rockCount(game));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SpawnRock)->RangeMultiplier(10)->Range(10, 1000000);
+
+// One integration and compaction step over N live particles; none expire so N stays fixed
+static void BM_ParticleUpdate(benchmark::State& state) {
+	const ParticleStyle immortal = { 1.0f, 1.0f, 1.0f, 10.0f, 100.0f, 0.0f, 360.0f, 1.0e6f, 1.0e6f };
+	ParticleSystem particles(0.0f);
+	particles.emit(400.0f, 300.0f, (int)state.range(0), immortal);
+	for (auto _ : state) {
+		particles.update(BENCH_DT);
+		benchmark::DoNotOptimize(particles.getCount());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParticleUpdate)->RangeMultiplier(10)->Range(10, 200000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,140 @@
+#include "AllocStats.h"
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define ALLOC_CALLER() _ReturnAddress()
+#else
+#define ALLOC_CALLER() __builtin_return_address(0)
+#endif
+
+namespace AllocStats {
+	// Totals only ever grow, so the hook never races with endFrame; frames are differences
+	struct CategorySlot {
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> bytes;
+	};
+	struct SiteSlot {
+		std::atomic<const void*> caller; // null until claimed, then fixed
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> bytes;
+	};
+
+	static CategorySlot totals[(int)AllocCategory::Count];
+	static SiteSlot sites[MAX_SITES]; // open addressing on the caller address
+	static thread_local AllocCategory active = AllocCategory::Other;
+
+	// Read and written only by whoever calls endFrame
+	static AllocCounters frameStart[(int)AllocCategory::Count];
+	static AllocCounters lastFrame[(int)AllocCategory::Count];
+	static AllocSite siteFrameStart[MAX_SITES];
+	static AllocSite lastFrameSites[MAX_SITES];
+	static int lastFrameSiteCount = 0;
+
+	static const char* const CATEGORY_NAMES[(int)AllocCategory::Count] = {
+		"Update", "Collisions", "Render", "Audio", "Other"
+	};
+
+#if MOLTEN_ALLOC_STATS
+	static void record(size_t bytes, const void* caller) {
+		CategorySlot& c = totals[(int)active];
+		c.count.fetch_add(1, std::memory_order_relaxed);
+		c.bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+		size_t start = ((uintptr_t)caller >> 4) % MAX_SITES;
+		for (int probe = 0; probe < MAX_SITES; ++probe) {
+			SiteSlot& s = sites[(start + probe) % MAX_SITES];
+			const void* owner = s.caller.load(std::memory_order_acquire);
+			if (!owner) {
+				if (s.caller.compare_exchange_strong(owner, caller, std::memory_order_acq_rel)) owner = caller;
+			}
+			if (owner == caller) {
+				s.count.fetch_add(1, std::memory_order_relaxed);
+				s.bytes.fetch_add(bytes, std::memory_order_relaxed);
+				return;
+			}
+		}
+		// Table full: the category totals still have it
+	}
+#endif
+
+	bool isEnabled() {
+		return MOLTEN_ALLOC_STATS != 0;
+	}
+
+	AllocCounters getTotal() {
+		AllocCounters total = { 0, 0 };
+		for (const auto& c : totals) {
+			total.count += c.count.load(std::memory_order_relaxed);
+			total.bytes += c.bytes.load(std::memory_order_relaxed);
+		}
+		return total;
+	}
+
+	void endFrame() {
+		for (int i = 0; i < (int)AllocCategory::Count; ++i) {
+			AllocCounters now = { totals[i].count.load(std::memory_order_relaxed), totals[i].bytes.load(std::memory_order_relaxed) };
+			lastFrame[i] = { now.count - frameStart[i].count, now.bytes - frameStart[i].bytes };
+			frameStart[i] = now;
+		}
+
+		lastFrameSiteCount = 0;
+		for (int i = 0; i < MAX_SITES; ++i) {
+			const void* caller = sites[i].caller.load(std::memory_order_acquire);
+			if (!caller) continue;
+			AllocSite now = { caller, sites[i].count.load(std::memory_order_relaxed), sites[i].bytes.load(std::memory_order_relaxed) };
+			if (now.count != siteFrameStart[i].count) {
+				lastFrameSites[lastFrameSiteCount++] = { caller, now.count - siteFrameStart[i].count, now.bytes - siteFrameStart[i].bytes };
+			}
+			siteFrameStart[i] = now;
+		}
+		std::sort(lastFrameSites, lastFrameSites + lastFrameSiteCount,
+			[](const AllocSite& a, const AllocSite& b) { return a.count > b.count; });
+	}
+
+	const AllocCounters& getLastFrame(AllocCategory category) {
+		return lastFrame[(int)category];
+	}
+
+	int getLastFrameSites(AllocSite* out, int maxSites) {
+		int count = std::min(maxSites, lastFrameSiteCount);
+		std::copy(lastFrameSites, lastFrameSites + count, out);
+		return count;
+	}
+
+	const char* getCategoryName(AllocCategory category) {
+		return CATEGORY_NAMES[(int)category];
+	}
+
+	AllocCategory getActive() {
+		return active;
+	}
+
+	void setActive(AllocCategory category) {
+		active = category;
+	}
+}
+
+#if MOLTEN_ALLOC_STATS
+// Replacements for the global allocation functions; the standard library routes the
+// nothrow forms through these. Over-aligned allocations keep the default and go uncounted.
+void* operator new(size_t size) {
+	AllocStats::record(size, ALLOC_CALLER());
+	if (void* p = malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+	AllocStats::record(size, ALLOC_CALLER());
+	if (void* p = malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+#endif
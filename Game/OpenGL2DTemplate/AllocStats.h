@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Profiler.h"
+
+// Optional counting of every heap allocation made through global operator new,
+// from any thread. Off unless MOLTEN_ALLOC_STATS is set; follows MOLTEN_PROFILE
+// by default. When on, AllocStats.cpp replaces the global operator new/delete.
+#if !defined(MOLTEN_ALLOC_STATS)
+#if MOLTEN_PROFILE
+#define MOLTEN_ALLOC_STATS 1
+#else
+#define MOLTEN_ALLOC_STATS 0
+#endif
+#endif
+
+// Subsystem an allocation is charged to; job workers and untagged threads count as Other
+enum class AllocCategory { Update, Collisions, Render, Audio, Other, Count };
+
+struct AllocCounters {
+	uint64_t count;
+	uint64_t bytes;
+};
+
+// One caller of operator new, by return address (resolve with addr2line or the debugger)
+struct AllocSite {
+	const void* caller;
+	uint64_t count;
+	uint64_t bytes;
+};
+
+namespace AllocStats {
+	static const int MAX_SITES = 256;
+
+	bool isEnabled();
+
+	// Every allocation since start
+	AllocCounters getTotal();
+
+	// Publishes the allocations since the previous call for getLastFrame and
+	// getLastFrameSites. Call once per frame, or around any span to measure.
+	void endFrame();
+	const AllocCounters& getLastFrame(AllocCategory category);
+	// Fills out with up to maxSites of last frame's callers, most allocations first; returns the count
+	int getLastFrameSites(AllocSite* out, int maxSites);
+	const char* getCategoryName(AllocCategory category);
+
+	// Category of the calling thread; AllocScope sets it
+	AllocCategory getActive();
+	void setActive(AllocCategory category);
+}
+
+// Charges every allocation the calling thread makes in the enclosing scope to one subsystem
+class AllocScope {
+private:
+	AllocCategory previous;
+
+public:
+	explicit AllocScope(AllocCategory category) : previous(AllocStats::getActive()) { AllocStats::setActive(category); }
+	~AllocScope() { AllocStats::setActive(previous); }
+	AllocScope(const AllocScope&) = delete;
+	AllocScope& operator=(const AllocScope&) = delete;
+};
+
+#if MOLTEN_ALLOC_STATS
+#define ALLOC_SCOPE(category) AllocScope PROFILE_CONCAT(allocScope, __LINE__)(category)
+#else
+#define ALLOC_SCOPE(category) ((void)0)
+#endif
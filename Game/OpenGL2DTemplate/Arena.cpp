@@ -0,0 +1,10 @@
+#include "Arena.h"
+
+Arena::Arena(size_t bytes)
+	: block(new unsigned char[bytes]), capacity(bytes), resource(block.get(), bytes, std::pmr::new_delete_resource()) {
+}
+
+Arena& Arena::frame() {
+	static thread_local Arena arena(FRAME_BYTES);
+	return arena;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <memory_resource>
+#include <memory>
+#include <cstddef>
+
+// Bump allocator for memory that all dies at the same moment. Allocating moves
+// a pointer through one preallocated block and freeing does nothing; reset()
+// hands the whole block back at once. A frame or level that outgrows the block
+// spills into heap chunks, which reset() also frees.
+//
+// getResource() plugs the arena into std::pmr containers.
+class Arena {
+public:
+	static const size_t FRAME_BYTES = 256 * 1024;
+
+private:
+	std::unique_ptr<unsigned char[]> block;
+	size_t capacity;
+	std::pmr::monotonic_buffer_resource resource;
+
+public:
+	explicit Arena(size_t bytes);
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	std::pmr::memory_resource* getResource() { return &resource; }
+	size_t getCapacity() const { return capacity; }
+
+	// Everything allocated from the arena is invalid afterwards
+	void reset() { resource.release(); }
+
+	// Scratch for the calling thread's current frame: the sim thread resets it at
+	// the start of every tick and the render thread at the start of every draw
+	static Arena& frame();
+};
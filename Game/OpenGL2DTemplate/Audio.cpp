@@ -1,25 +1,83 @@
 #include "Audio.h"
+#include "AudioMixer.h"
+#include "AllocStats.h"
+#include <cstring>
 
-#ifdef _WIN32
-#include <windows.h>
-#include <mmsystem.h>
-#pragma comment(lib, "winmm.lib")
-#endif
+namespace {
+	AudioMixer mixer;
+	SoundBank bank;
 
-void Audio::PlayMusic(const std::string& wavPath) {
-#ifdef _WIN32
-	PlaySoundA(wavPath.c_str(), NULL, SND_FILENAME | SND_ASYNC | SND_LOOP);
-#endif
+	// Two streams so a new track can be opened while the mixer may still be reading the old one
+	MusicStream music[2];
+	char musicPaths[2][256];
+	int currentMusic = 0;
+
+	// Sound effects triggered since the last Flush, merged per sound
+	struct PendingSfx {
+		int count;
+		float panSum;
+	};
+	PendingSfx pending[(int)SoundId::Count];
+}
+
+bool Audio::Init(AudioOutput output, const char* wavPath) {
+	AudioSink* sink = nullptr;
+	switch (output) {
+	case AudioOutput::Device: sink = createDeviceAudioSink(); break;
+	case AudioOutput::WavFile: sink = wavPath ? new WavFileAudioSink(wavPath) : nullptr; break;
+	case AudioOutput::None: sink = new NullAudioSink(); break;
+	}
+	mixer.stop(); // the bank must not be reloaded under a running mixer
+	bank.load(AudioMixer::SAMPLE_RATE);
+	return mixer.start(sink);
+}
+
+void Audio::Shutdown() {
+	mixer.stop();
+	music[0].close();
+	music[1].close();
+}
+
+void Audio::PlayMusic(const char* wavPath) {
+	if (!mixer.isRunning()) return;
+
+	// Restarting the current track reuses its mapping
+	if (music[currentMusic].isOpen() && strcmp(musicPaths[currentMusic], wavPath) == 0) {
+		mixer.playMusic(&music[currentMusic], 0.6f);
+		return;
+	}
+
+	int next = 1 - currentMusic;
+	mixer.stopMusic();
+	if (strlen(wavPath) >= sizeof(musicPaths[next]) || !music[next].open(wavPath, AudioMixer::SAMPLE_RATE)) return;
+	strcpy(musicPaths[next], wavPath);
+	currentMusic = next;
+	mixer.playMusic(&music[currentMusic], 0.6f);
 }
 
 void Audio::StopMusic() {
-#ifdef _WIN32
-	PlaySoundA(NULL, 0, 0);
-#endif
+	mixer.stopMusic();
+}
+
+void Audio::PlaySfx(SoundId id, float pan) {
+	if (!mixer.isRunning()) return;
+	PendingSfx& p = pending[(int)id];
+	++p.count;
+	p.panSum += pan;
+}
+
+void Audio::Flush() {
+	ALLOC_SCOPE(AllocCategory::Audio);
+	for (int i = 0; i < (int)SoundId::Count; ++i) {
+		PendingSfx& p = pending[i];
+		if (p.count == 0) continue;
+		const SoundInfo& info = SoundBank::getInfo((SoundId)i);
+		mixer.play(&bank.get((SoundId)i), 1.0f, false, p.panSum / p.count, i + 1, info.maxVoices, info.priority);
+		p.count = 0;
+		p.panSum = 0.0f;
+	}
 }
 
-void Audio::PlaySfx(const std::string& wavPath) {
-#ifdef _WIN32
-	PlaySoundA(wavPath.c_str(), NULL, SND_FILENAME | SND_ASYNC);
-#endif
+void Audio::SetLavaRumble(float intensity) {
+	mixer.setRumbleIntensity(intensity);
 }
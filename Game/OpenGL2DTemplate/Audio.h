@@ -1,12 +1,29 @@
 #pragma once
-#include <string>
+#include "SoundBank.h"
+
+enum class AudioOutput {
+	Device,   // waveOut on Windows, ALSA on Linux builds with MOLTEN_ALSA
+	WavFile,  // record the mix to a WAV file (tests, headless runs)
+	None      // mix and discard in real time, so playback state still advances
+};
 
 class Audio {
 public:
-	// Starts looping background music from a WAV file
-	static void PlayMusic(const std::string& wavPath);
+	// Decodes every sound effect and starts the mixer thread. Until this is called every other call is a no-op.
+	static bool Init(AudioOutput output = AudioOutput::Device, const char* wavPath = nullptr);
+	static void Shutdown();
+
+	// Starts looping background music streamed from a WAV file
+	static void PlayMusic(const char* wavPath);
 	static void StopMusic();
 
-	// Plays a one-shot sound effect from a WAV file
-	static void PlaySfx(const std::string& wavPath);
+	// Queues a preloaded sound effect panned from -1 (left) to 1 (right). Repeats of the
+	// same sound before the next Flush merge into one voice. Never allocates.
+	static void PlaySfx(SoundId id, float pan = 0.0f);
+
+	// Sends this frame's queued sound effects to the mixer; call once per tick
+	static void Flush();
+
+	// Loudness of the synthesized lava rumble, 0..1; cheap enough to call every tick
+	static void SetLavaRumble(float intensity);
 };
@@ -0,0 +1,168 @@
+#include "AudioMixer.h"
+#include "AllocStats.h"
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+AudioMixer::AudioMixer() : mixCounter(0), music(nullptr), musicGain(0), sink(nullptr), running(false) {
+	memset(voices, 0, sizeof(voices));
+}
+
+AudioMixer::~AudioMixer() {
+	stop();
+}
+
+bool AudioMixer::start(AudioSink* outputSink) {
+	stop();
+	sink = outputSink;
+	if (!sink || !sink->open(SAMPLE_RATE, CHANNELS)) {
+		delete sink;
+		sink = nullptr;
+		return false;
+	}
+	memset(voices, 0, sizeof(voices));
+	music = nullptr;
+	rumble.init(SAMPLE_RATE, BUFFER_FRAMES);
+	running = true;
+	worker = std::thread(&AudioMixer::run, this);
+	return true;
+}
+
+void AudioMixer::stop() {
+	running = false;
+	if (worker.joinable()) worker.join();
+	if (sink) {
+		sink->close();
+		delete sink;
+		sink = nullptr;
+	}
+}
+
+bool AudioMixer::play(const Sound* sound, float gain, bool loop, float pan, int group, int maxVoices, int priority) {
+	if (!running || !sound || sound->frames == 0) return false;
+	return commands.push({ CommandType::Play, loop, (uint8_t)group, (uint8_t)maxVoices, (uint8_t)priority, gain, pan, sound, nullptr });
+}
+
+bool AudioMixer::playMusic(MusicStream* stream, float gain) {
+	if (!running || !stream || !stream->isOpen()) return false;
+	return commands.push({ CommandType::PlayMusic, true, 0, 0, 0, gain, 0.0f, nullptr, stream });
+}
+
+bool AudioMixer::stopMusic() {
+	if (!running) return false;
+	return commands.push({ CommandType::StopMusic, false, 0, 0, 0, 0.0f, 0.0f, nullptr, nullptr });
+}
+
+bool AudioMixer::stopAll() {
+	if (!running) return false;
+	return commands.push({ CommandType::StopAll, false, 0, 0, 0, 0.0f, 0.0f, nullptr, nullptr });
+}
+
+void AudioMixer::run() {
+	ALLOC_SCOPE(AllocCategory::Audio);
+	while (running.load(std::memory_order_relaxed)) {
+		applyCommands();
+		mix();
+		sink->write(output, BUFFER_FRAMES); // blocks until the device wants more
+		++mixCounter;
+	}
+}
+
+void AudioMixer::applyCommands() {
+	Command command;
+	while (commands.pop(command)) {
+		switch (command.type) {
+		case CommandType::Play:
+			startVoice(command);
+			break;
+		case CommandType::PlayMusic:
+			music = command.music;
+			musicGain = (int)(command.gain * 256.0f);
+			music->rewind();
+			break;
+		case CommandType::StopMusic:
+			music = nullptr;
+			break;
+		case CommandType::StopAll:
+			for (auto& v : voices) v.active = false;
+			music = nullptr;
+			break;
+		}
+	}
+}
+
+void AudioMixer::startVoice(const Command& command) {
+	// A sound at its cap restarts its own oldest instance instead of taking another voice
+	Voice* oldestInGroup = nullptr;
+	int inGroup = 0;
+	for (auto& v : voices) {
+		if (!v.active || v.group != command.group) continue;
+		++inGroup;
+		if (!oldestInGroup || v.startedAt < oldestInGroup->startedAt) oldestInGroup = &v;
+	}
+
+	Voice* target = nullptr;
+	if (inGroup >= command.maxVoices) {
+		target = oldestInGroup;
+	}
+	else {
+		// Free voice first, otherwise the oldest of the lowest priority, if that is not above ours
+		for (auto& v : voices) {
+			if (!v.active) { target = &v; break; }
+			if (!target || v.priority < target->priority || (v.priority == target->priority && v.startedAt < target->startedAt)) target = &v;
+		}
+		if (target && target->active && target->priority > command.priority) return;
+	}
+	if (!target) return;
+
+	// Equal-power pan, normalised so a centred sound plays at full gain
+	float pan = command.pan < -1.0f ? -1.0f : (command.pan > 1.0f ? 1.0f : command.pan);
+	float angle = (pan + 1.0f) * 0.785398f;
+	float left = std::min(1.0f, cosf(angle) * 1.41421f);
+	float right = std::min(1.0f, sinf(angle) * 1.41421f);
+
+	target->sound = command.sound;
+	target->position = 0;
+	target->startedAt = mixCounter;
+	target->gainLeft = (int)(command.gain * left * 256.0f + 0.5f); // rounded, or centre comes out at 255/256
+	target->gainRight = (int)(command.gain * right * 256.0f + 0.5f);
+	target->group = command.group;
+	target->priority = command.priority;
+	target->loop = command.loop;
+	target->active = true;
+}
+
+void AudioMixer::mix() {
+	memset(accumulator, 0, sizeof(accumulator));
+
+	if (music) {
+		music->fill();
+		music->mixInto(accumulator, BUFFER_FRAMES, musicGain);
+	}
+	rumble.mixInto(accumulator, BUFFER_FRAMES);
+
+	for (auto& v : voices) {
+		if (!v.active) continue;
+		const Sound& s = *v.sound;
+
+		for (int frame = 0; frame < BUFFER_FRAMES; ++frame) {
+			if (v.position >= s.frames) {
+				if (!v.loop) { v.active = false; break; }
+				v.position = 0;
+			}
+			const int16_t* in = &s.samples[(size_t)v.position * s.channels];
+			int left = in[0];
+			int right = s.channels == 2 ? in[1] : in[0];
+			accumulator[frame * 2] += (left * v.gainLeft) >> 8;
+			accumulator[frame * 2 + 1] += (right * v.gainRight) >> 8;
+			++v.position;
+		}
+	}
+
+	for (int i = 0; i < BUFFER_FRAMES * CHANNELS; ++i) {
+		int32_t sample = accumulator[i];
+		if (sample > 32767) sample = 32767;
+		if (sample < -32768) sample = -32768;
+		output[i] = (int16_t)sample;
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include "SpscQueue.h"
+#include "SoundBank.h"
+#include "MusicStream.h"
+#include "LavaRumble.h"
+#include "AudioSink.h"
+
+// Software mixer with a fixed voice pool, running on its own thread.
+// The game thread only pushes small commands into a lock-free queue, so
+// triggering a sound never blocks on I/O or on the mixer.
+class AudioMixer {
+public:
+	static const int MAX_VOICES = 32;
+	static const int SAMPLE_RATE = 44100;
+	static const int CHANNELS = 2;
+	static const int BUFFER_FRAMES = 512;  // ~11.6 ms per mix
+
+private:
+	enum class CommandType : uint8_t { Play, PlayMusic, StopMusic, StopAll };
+
+	struct Command {
+		CommandType type;
+		bool loop;
+		uint8_t group;     // voices of the same sound share a concurrency cap
+		uint8_t maxVoices;
+		uint8_t priority;
+		float gain;
+		float pan;         // -1 left .. 1 right
+		const Sound* sound;
+		MusicStream* music;
+	};
+
+	struct Voice {
+		const Sound* sound;
+		uint32_t position;  // next frame to play
+		uint32_t startedAt; // mix counter when triggered, for stealing the oldest
+		int gainLeft;       // 8.8 fixed point, pan folded in
+		int gainRight;
+		uint8_t group;
+		uint8_t priority;
+		bool loop;
+		bool active;
+	};
+
+	SpscQueue<Command, 256> commands;
+	Voice voices[MAX_VOICES];
+	uint32_t mixCounter;
+
+	// Music is streamed rather than held in a voice, so it can never be stolen
+	MusicStream* music;
+	int musicGain;
+
+	LavaRumble rumble;
+
+	AudioSink* sink;
+	std::thread worker;
+	std::atomic<bool> running;
+
+	int32_t accumulator[BUFFER_FRAMES * CHANNELS];
+	int16_t output[BUFFER_FRAMES * CHANNELS];
+
+public:
+	AudioMixer();
+	~AudioMixer();
+	AudioMixer(const AudioMixer&) = delete;
+	AudioMixer& operator=(const AudioMixer&) = delete;
+
+	// Takes ownership of sink and starts the mixer thread
+	bool start(AudioSink* outputSink);
+	void stop();
+	bool isRunning() const { return running.load(std::memory_order_relaxed); }
+
+	// Game thread only. Sounds and streams must outlive the mixer. False if the command queue is full.
+	bool play(const Sound* sound, float gain, bool loop, float pan = 0.0f, int group = 0, int maxVoices = MAX_VOICES, int priority = 0);
+	bool playMusic(MusicStream* stream, float gain);
+	bool stopMusic();
+	bool stopAll();
+
+	// Any thread; 0 silences the rumble
+	void setRumbleIntensity(float intensity) { rumble.setIntensity(intensity); }
+
+private:
+	void run();
+	void applyCommands();
+	void startVoice(const Command& command);
+	void mix();
+};
@@ -0,0 +1,197 @@
+#include "AudioSink.h"
+#include <thread>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <mmsystem.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+#ifdef MOLTEN_ALSA
+#include <alsa/asoundlib.h>
+#endif
+
+NullAudioSink::NullAudioSink() : sampleRate(44100) {}
+
+bool NullAudioSink::open(int rate, int /*channels*/) {
+	sampleRate = rate;
+	nextDeadline = std::chrono::steady_clock::now();
+	return true;
+}
+
+void NullAudioSink::write(const int16_t* /*samples*/, int frames) {
+	nextDeadline += std::chrono::microseconds((long long)frames * 1000000 / sampleRate);
+	std::this_thread::sleep_until(nextDeadline);
+}
+
+// --- WAV file ---
+
+static void writeU32(FILE* f, uint32_t v) { unsigned char b[4] = { (unsigned char)v, (unsigned char)(v >> 8), (unsigned char)(v >> 16), (unsigned char)(v >> 24) }; fwrite(b, 1, 4, f); }
+static void writeU16(FILE* f, uint16_t v) { unsigned char b[2] = { (unsigned char)v, (unsigned char)(v >> 8) }; fwrite(b, 1, 2, f); }
+
+static void writeWavHeader(FILE* f, int rate, int channels, uint32_t dataBytes) {
+	fwrite("RIFF", 1, 4, f);
+	writeU32(f, 36 + dataBytes);
+	fwrite("WAVEfmt ", 1, 8, f);
+	writeU32(f, 16);
+	writeU16(f, 1); // PCM
+	writeU16(f, (uint16_t)channels);
+	writeU32(f, (uint32_t)rate);
+	writeU32(f, (uint32_t)(rate * channels * 2));
+	writeU16(f, (uint16_t)(channels * 2));
+	writeU16(f, 16);
+	fwrite("data", 1, 4, f);
+	writeU32(f, dataBytes);
+}
+
+WavFileAudioSink::WavFileAudioSink(const char* wavPath) : path(wavPath), file(nullptr), channels(2), dataBytes(0) {}
+
+WavFileAudioSink::~WavFileAudioSink() {
+	close();
+}
+
+bool WavFileAudioSink::open(int rate, int channelCount) {
+	NullAudioSink::open(rate, channelCount);
+	channels = channelCount;
+	dataBytes = 0;
+	file = fopen(path, "wb");
+	if (!file) return false;
+	writeWavHeader(file, rate, channels, 0); // sizes patched in close()
+	return true;
+}
+
+void WavFileAudioSink::write(const int16_t* samples, int frames) {
+	if (file) {
+		// Samples are written in native order; every platform we ship on is little-endian like WAV
+		dataBytes += (uint32_t)fwrite(samples, sizeof(int16_t), (size_t)frames * channels, file) * sizeof(int16_t);
+	}
+	NullAudioSink::write(samples, frames);
+}
+
+void WavFileAudioSink::close() {
+	if (!file) return;
+	fseek(file, 0, SEEK_SET);
+	writeWavHeader(file, sampleRate, channels, dataBytes);
+	fclose(file);
+	file = nullptr;
+}
+
+// --- waveOut ---
+
+#ifdef _WIN32
+class WaveOutAudioSink : public AudioSink {
+private:
+	static const int BUFFER_COUNT = 4;
+	static const int MAX_BUFFER_SAMPLES = 4096;
+
+	HWAVEOUT device;
+	WAVEHDR headers[BUFFER_COUNT];
+	int16_t buffers[BUFFER_COUNT][MAX_BUFFER_SAMPLES];
+	int channels;
+	int next;
+
+public:
+	WaveOutAudioSink() : device(NULL), channels(2), next(0) { memset(headers, 0, sizeof(headers)); }
+	~WaveOutAudioSink() override { close(); }
+
+	bool open(int rate, int channelCount) override {
+		channels = channelCount;
+		WAVEFORMATEX format = {};
+		format.wFormatTag = WAVE_FORMAT_PCM;
+		format.nChannels = (WORD)channels;
+		format.nSamplesPerSec = rate;
+		format.wBitsPerSample = 16;
+		format.nBlockAlign = (WORD)(channels * 2);
+		format.nAvgBytesPerSec = rate * format.nBlockAlign;
+		if (waveOutOpen(&device, WAVE_MAPPER, &format, 0, 0, CALLBACK_NULL) != MMSYSERR_NOERROR) return false;
+		for (int i = 0; i < BUFFER_COUNT; ++i) {
+			headers[i].lpData = (LPSTR)buffers[i];
+			headers[i].dwFlags = WHDR_DONE; // free to fill
+		}
+		return true;
+	}
+
+	void write(const int16_t* samples, int frames) override {
+		WAVEHDR& header = headers[next];
+		while (!(header.dwFlags & WHDR_DONE)) Sleep(1); // the device still owns this buffer
+		if (header.dwFlags & WHDR_PREPARED) waveOutUnprepareHeader(device, &header, sizeof(WAVEHDR));
+
+		int count = frames * channels;
+		if (count > MAX_BUFFER_SAMPLES) count = MAX_BUFFER_SAMPLES;
+		memcpy(buffers[next], samples, count * sizeof(int16_t));
+		header.dwBufferLength = count * sizeof(int16_t);
+		header.dwFlags = 0;
+		waveOutPrepareHeader(device, &header, sizeof(WAVEHDR));
+		waveOutWrite(device, &header, sizeof(WAVEHDR));
+		next = (next + 1) % BUFFER_COUNT;
+	}
+
+	void close() override {
+		if (!device) return;
+		waveOutReset(device);
+		for (int i = 0; i < BUFFER_COUNT; ++i) {
+			if (headers[i].dwFlags & WHDR_PREPARED) waveOutUnprepareHeader(device, &headers[i], sizeof(WAVEHDR));
+		}
+		waveOutClose(device);
+		device = NULL;
+	}
+};
+#endif
+
+// --- ALSA ---
+
+#ifdef MOLTEN_ALSA
+class AlsaAudioSink : public AudioSink {
+private:
+	snd_pcm_t* pcm;
+	int channels;
+
+public:
+	AlsaAudioSink() : pcm(nullptr), channels(2) {}
+	~AlsaAudioSink() override { close(); }
+
+	bool open(int rate, int channelCount) override {
+		channels = channelCount;
+		if (snd_pcm_open(&pcm, "default", SND_PCM_STREAM_PLAYBACK, 0) < 0) {
+			pcm = nullptr;
+			return false;
+		}
+		// 40 ms of device latency keeps sfx responsive without underruns
+		if (snd_pcm_set_params(pcm, SND_PCM_FORMAT_S16, SND_PCM_ACCESS_RW_INTERLEAVED, channels, rate, 1, 40000) < 0) {
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	void write(const int16_t* samples, int frames) override {
+		while (frames > 0) {
+			snd_pcm_sframes_t written = snd_pcm_writei(pcm, samples, frames);
+			if (written < 0) {
+				if (snd_pcm_recover(pcm, (int)written, 1) < 0) return;
+				continue;
+			}
+			frames -= (int)written;
+			samples += written * channels;
+		}
+	}
+
+	void close() override {
+		if (!pcm) return;
+		snd_pcm_drain(pcm);
+		snd_pcm_close(pcm);
+		pcm = nullptr;
+	}
+};
+#endif
+
+AudioSink* createDeviceAudioSink() {
+#if defined(_WIN32)
+	return new WaveOutAudioSink();
+#elif defined(MOLTEN_ALSA)
+	return new AlsaAudioSink();
+#else
+	return nullptr;
+#endif
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+
+// Where the mixer's interleaved 16-bit frames end up. write() blocks until the
+// device can take more, which is what paces the mixer thread.
+class AudioSink {
+public:
+	virtual ~AudioSink() {}
+	virtual bool open(int sampleRate, int channels) = 0;
+	virtual void write(const int16_t* samples, int frames) = 0;
+	virtual void close() = 0;
+};
+
+// Discards audio in real time; used when no device is available
+class NullAudioSink : public AudioSink {
+protected:
+	int sampleRate;
+	std::chrono::steady_clock::time_point nextDeadline;
+
+public:
+	NullAudioSink();
+	bool open(int rate, int channels) override;
+	void write(const int16_t* samples, int frames) override;
+	void close() override {}
+};
+
+// Records everything the mixer produces to a WAV file, paced in real time so
+// the recording lines up with the game session (used for audio tests)
+class WavFileAudioSink : public NullAudioSink {
+private:
+	const char* path;
+	FILE* file;
+	int channels;
+	uint32_t dataBytes;
+
+public:
+	explicit WavFileAudioSink(const char* wavPath);
+	~WavFileAudioSink() override;
+	bool open(int rate, int channels) override;
+	void write(const int16_t* samples, int frames) override;
+	void close() override;
+};
+
+// Default output device: waveOut on Windows, ALSA on Linux when built with MOLTEN_ALSA.
+// Returns null where neither is available.
+AudioSink* createDeviceAudioSink();
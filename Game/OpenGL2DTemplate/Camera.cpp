@@ -0,0 +1,36 @@
+#include "Camera.h"
+
+Camera::Camera(float viewH, float levelH)
+	: y(0.0f), viewHeight(viewH), levelHeight(levelH),
+	anchor(0.4f), followSpeed(5.0f)
+{
+}
+
+void Camera::update(float targetY, float deltaTime) {
+	float desired = clampY(targetY - viewHeight * anchor);
+
+	// Exponential follow, frame-rate independent enough for small dt
+	float t = followSpeed * deltaTime;
+	if (t > 1.0f) t = 1.0f;
+	y += (desired - y) * t;
+}
+
+void Camera::snapTo(float targetY) {
+	y = clampY(targetY - viewHeight * anchor);
+}
+
+void Camera::apply() const {
+	glTranslatef(0.0f, -y, 0.0f);
+}
+
+void Camera::setLevelHeight(float levelH) {
+	levelHeight = levelH;
+	y = clampY(y);
+}
+
+float Camera::clampY(float newY) const {
+	float maxY = levelHeight - viewHeight;
+	if (newY > maxY) newY = maxY;
+	if (newY < 0.0f) newY = 0.0f;
+	return newY;
+}
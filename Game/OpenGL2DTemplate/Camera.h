@@ -0,0 +1,36 @@
+#pragma once
+#include <glut.h>
+
+// Vertical scrolling camera; the view is a band [y, y + viewHeight] of the level
+class Camera {
+private:
+	float y;
+	float viewHeight;
+	float levelHeight;
+
+	// Where the followed target sits inside the view (0 = bottom, 1 = top)
+	float anchor;
+	float followSpeed;
+
+public:
+	Camera(float viewH, float levelH);
+
+	void update(float targetY, float deltaTime);
+	void snapTo(float targetY);
+
+	// Translates the modelview so world coordinates map into the view band
+	void apply() const;
+
+	// True if the vertical span [bottom, top] intersects the view band
+	bool isVisible(float bottom, float top) const { return top >= y && bottom <= y + viewHeight; }
+
+	float getY() const { return y; }
+	float getTop() const { return y + viewHeight; }
+	float getViewHeight() const { return viewHeight; }
+	float getLevelHeight() const { return levelHeight; }
+
+	void setLevelHeight(float levelH);
+
+private:
+	float clampY(float newY) const;
+};
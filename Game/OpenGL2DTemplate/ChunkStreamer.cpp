@@ -0,0 +1,116 @@
+#include "ChunkStreamer.h"
+#include <random>
+#include <cmath>
+#include <utility>
+
+static const float ROW_SPACING = 100.0f;
+
+ChunkStreamer::ChunkStreamer()
+	: seed(0), levelWidth(0.0f), chunkHeight(1.0f),
+	readyHead(0), readyCount(0), requestedUpTo(-1), generatedUpTo(-1), running(false)
+{
+}
+
+ChunkStreamer::~ChunkStreamer() {
+	stop();
+}
+
+void ChunkStreamer::start(unsigned newSeed, float width, float height) {
+	stop();
+	seed = newSeed;
+	levelWidth = width;
+	chunkHeight = height;
+	readyHead = 0;
+	readyCount = 0;
+	for (auto& chunk : ready) reserveChunk(chunk);
+	reserveChunk(building);
+	requestedUpTo = -1;
+	generatedUpTo = -1;
+	running = true;
+	worker = std::thread(&ChunkStreamer::run, this);
+}
+
+void ChunkStreamer::stop() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		running = false;
+	}
+	wake.notify_one();
+	if (worker.joinable()) worker.join();
+}
+
+void ChunkStreamer::requestUpTo(int index) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (index <= requestedUpTo) return;
+		requestedUpTo = index;
+	}
+	wake.notify_one();
+}
+
+void ChunkStreamer::take(LevelChunk& out) {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		finished.wait(lock, [this] { return readyCount > 0; });
+		std::swap(out, ready[readyHead]);
+		reserveChunk(ready[readyHead]); // out's buffers join the ring; a no-op once they have
+		readyHead = (readyHead + 1) % MAX_READY;
+		--readyCount;
+	}
+	wake.notify_one(); // a slot opened up
+}
+
+void ChunkStreamer::reserveChunk(LevelChunk& chunk) const {
+	// At most one platform and one gem per row, plus the ground
+	size_t rows = (size_t)ceilf(chunkHeight / ROW_SPACING) + 2;
+	chunk.platforms.reserve(rows);
+	chunk.gems.reserve(rows);
+}
+
+void ChunkStreamer::run() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wake.wait(lock, [this] { return !running || (generatedUpTo < requestedUpTo && readyCount < MAX_READY); });
+		if (!running) return;
+
+		int index = generatedUpTo + 1;
+		lock.unlock();
+		generate(seed, index, levelWidth, chunkHeight, building);
+		lock.lock();
+
+		std::swap(building, ready[(readyHead + readyCount) % MAX_READY]);
+		++readyCount;
+		generatedUpTo = index;
+		finished.notify_one();
+	}
+}
+
+void ChunkStreamer::generate(unsigned seed, int index, float levelWidth, float chunkHeight, LevelChunk& out) {
+	std::mt19937 rng(seed * 2654435761u + (unsigned)index);
+	std::uniform_real_distribution<float> xDist(80.0f, levelWidth - 80.0f);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	const float widths[4] = { 100.0f, 120.0f, 140.0f, 160.0f };
+
+	out.index = index;
+	out.bottomY = index * chunkHeight;
+	out.topY = out.bottomY + chunkHeight;
+	out.platforms.clear();
+	out.gems.clear();
+
+	float rowY = out.bottomY;
+	if (index == 0) {
+		out.platforms.push_back({ levelWidth * 0.5f, 20.0f, 240.0f, 24.0f }); // ground
+		rowY = 120.0f;
+	}
+
+	for (; rowY < out.topY; rowY += ROW_SPACING) {
+		float w = widths[rng() % 4];
+		float px = xDist(rng);
+		out.platforms.push_back({ px, rowY, w, 20.0f });
+
+		// Roughly every other row gets a gem floating between this platform and the next
+		if (unit(rng) < 0.5f) {
+			out.gems.push_back({ xDist(rng), rowY + ROW_SPACING * 0.6f });
+		}
+	}
+}
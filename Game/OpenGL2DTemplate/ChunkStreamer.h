@@ -0,0 +1,56 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "LevelChunk.h"
+
+// Generates endless-mode level chunks on a worker thread, ahead of the game.
+// Chunk i is a pure function of (seed, i) and the game takes chunks in order at
+// ticks of its own choosing, waiting if the worker is behind, so gameplay is
+// identical however the worker is scheduled.
+// Finished chunks wait in a fixed ring and trade buffers with the caller, so
+// once every buffer has held a chunk, streaming no longer allocates.
+class ChunkStreamer {
+public:
+	static const int MAX_READY = 4; // finished chunks held for the game; the worker waits when all are full
+
+private:
+	unsigned seed;
+	float levelWidth;
+	float chunkHeight;
+
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable wake;     // the worker waits on this for requests and free slots
+	std::condition_variable finished; // take() waits on this for the worker
+	LevelChunk ready[MAX_READY];
+	int readyHead;      // oldest finished chunk
+	int readyCount;
+	LevelChunk building; // the worker's buffer, swapped into the ring when done
+	int requestedUpTo;  // highest chunk index the game wants generated
+	int generatedUpTo;  // highest chunk index the worker has produced
+	bool running;
+
+public:
+	ChunkStreamer();
+	~ChunkStreamer();
+
+	void start(unsigned seed, float levelWidth, float chunkHeight);
+	void stop();
+
+	// Ask for every chunk up to and including index; never blocks
+	void requestUpTo(int index);
+
+	// Swaps the next chunk in order into out, taking out's buffers for reuse.
+	// Blocks until the worker has finished it, so it must already be requested.
+	void take(LevelChunk& out);
+
+	float getChunkHeight() const { return chunkHeight; }
+	int chunkIndexAt(float y) const { return (int)(y / chunkHeight); }
+
+	static void generate(unsigned seed, int index, float levelWidth, float chunkHeight, LevelChunk& out);
+
+private:
+	void reserveChunk(LevelChunk& chunk) const;
+	void run();
+};
@@ -1,27 +1,26 @@
 #include "Collectable.h"
+#include "GLStats.h"
 #include <cmath>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+// Palette slots
+static const int GEM_COLOR = 0, SPARKLE_COLOR = 1, BASE_COLOR = 2;
+
 Collectable::Collectable(float startX, float startY, float gemSize)
-	: x(startX), y(startY), size(gemSize),
-	rotationAngle(0.0f), scaleAnimation(1.0f), animationTime(0.0f),
-	isVisible(true)
+	: x(startX), y(startY), size(gemSize), isVisible(true)
 {
-	// Gem color (blue crystal)
-	gemColor[0] = 0.2f; gemColor[1] = 0.6f; gemColor[2] = 1.0f;
-
-	// Sparkle color (white)
-	sparkleColor[0] = 1.0f; sparkleColor[1] = 1.0f; sparkleColor[2] = 1.0f;
+}
 
-	// Base color (dark blue)
-	baseColor[0] = 0.1f; baseColor[1] = 0.3f; baseColor[2] = 0.5f;
+CollectableAnimation::CollectableAnimation()
+	: rotationAngle(0.0f), scaleAnimation(1.0f), animationTime(0.0f), material(Material::Gem)
+{
 }
 
-void Collectable::update(float deltaTime) {
-	if (!isVisible) return;
+void CollectableAnimation::update(const Collectable& gem, float deltaTime) {
+	if (!gem.getIsVisible()) return;
 
 	animationTime += deltaTime;
 
@@ -35,16 +34,18 @@ void Collectable::update(float deltaTime) {
 	scaleAnimation = 1.0f + 0.2f * sin(animationTime * 3.0f);
 }
 
-void Collectable::render() {
-	if (!isVisible) return;
+void CollectableAnimation::render(const Collectable& gem) const {
+	if (!gem.getIsVisible()) return;
+	const float (*colors)[3] = Palette::get(material).colors;
+	float size = gem.getSize();
 
 	glPushMatrix();
-	glTranslatef(x, y, 0.0f);
+	glTranslatef(gem.getX(), gem.getY(), 0.0f);
 	glRotatef(rotationAngle, 0.0f, 0.0f, 1.0f);
 	glScalef(scaleAnimation, scaleAnimation, 1.0f);
 
 	// 1. Base (circle - triangle fan)
-	glColor3fv(baseColor);
+	glColor3fv(colors[BASE_COLOR]);
 	glBegin(GL_TRIANGLE_FAN);
 	glVertex2f(0.0f, 0.0f);
 	for (int i = 0; i <= 20; i++) {
@@ -54,7 +55,7 @@ void Collectable::render() {
 	glEnd();
 
 	// 2. Main gem (hexagon using triangles)
-	glColor3fv(gemColor);
+	glColor3fv(colors[GEM_COLOR]);
 	float hexRadius = size * 0.5f;
 	glBegin(GL_TRIANGLE_FAN);
 	glVertex2f(0.0f, 0.0f);
@@ -65,7 +66,7 @@ void Collectable::render() {
 	glEnd();
 
 	// 3. Sparkle points (small triangles)
-	glColor3fv(sparkleColor);
+	glColor3fv(colors[SPARKLE_COLOR]);
 	float sparkleSize = size * 0.15f;
 	
 	// Top sparkle
@@ -96,15 +97,6 @@ void Collectable::collect() {
 	isVisible = false;
 }
 
-bool Collectable::isColliding(float objX, float objY, float objRadius) const {
-	if (!isVisible) return false;
-
-	float dx = x - objX;
-	float dy = y - objY;
-	float distance = sqrt(dx * dx + dy * dy);
-	return distance < (size * 0.5f + objRadius);
-}
-
 void Collectable::setPosition(float newX, float newY) {
 	x = newX;
 	y = newY;
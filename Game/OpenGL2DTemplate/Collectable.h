@@ -1,6 +1,11 @@
 #pragma once
 #include <glut.h>
+#include "Palette.h"
+#include <cmath>
 
+// Hot record: everything the collision and lava passes read. Animation state
+// lives in CollectableAnimation, a separate component of the same entity, so
+// those passes stream 16 bytes per gem instead of the whole object.
 class Collectable {
 private:
 	// Position
@@ -9,32 +14,25 @@ private:
 
 	// Dimensions
 	float size;
-	
-	// Colors
-	float gemColor[3];
-	float sparkleColor[3];
-	float baseColor[3];
-
-	// Animation
-	float rotationAngle;
-	float scaleAnimation;
-	float animationTime;
 	bool isVisible;
 
 public:
 	// Constructor
 	Collectable(float startX, float startY, float gemSize = 20.0f);
 
-	// Update and render
-	void update(float deltaTime);
-	void render();
-
 	// Collection
 	void collect();
 	bool getIsVisible() const { return isVisible; }
 
-	// Collision detection
-	bool isColliding(float objX, float objY, float objRadius) const;
+	// Collision detection; inline so the collision passes don't make a call per entity
+	bool isColliding(float objX, float objY, float objRadius) const {
+		if (!isVisible) return false;
+
+		float dx = x - objX;
+		float dy = y - objY;
+		float distance = sqrt(dx * dx + dy * dy);
+		return distance < (size * 0.5f + objRadius);
+	}
 
 	// Getters
 	float getX() const { return x; }
@@ -43,4 +41,20 @@ public:
 
 	// Setters
 	void setPosition(float newX, float newY);
+};
+
+// Cold record: spin and pulse, touched only by the update and render passes
+class CollectableAnimation {
+private:
+	float rotationAngle;
+	float scaleAnimation;
+	float animationTime;
+	Material material;
+
+public:
+	CollectableAnimation();
+
+	// Update and render
+	void update(const Collectable& gem, float deltaTime);
+	void render(const Collectable& gem) const;
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Door.h"
+#include "GLStats.h"
 #include <cmath>
 
 Door::Door(float startX, float startY, float width, float height)
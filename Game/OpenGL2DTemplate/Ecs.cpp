@@ -0,0 +1,160 @@
+#include "Ecs.h"
+
+World::World(std::pmr::memory_resource* memory) : resource(memory), locations(memory), freeIndices(memory), tableVersion(0) {
+}
+
+World::World(const World& other) : World() {
+	*this = other;
+}
+
+World& World::operator=(const World& other) {
+	if (this == &other) return *this;
+
+	bool sameLayout = tables.size() == other.tables.size();
+	for (size_t i = 0; sameLayout && i < tables.size(); ++i) sameLayout = tables[i]->types == other.tables[i]->types;
+
+	if (sameLayout) {
+		// Assign in place so the arrays keep their capacity and cached queries stay valid
+		for (size_t i = 0; i < tables.size(); ++i) {
+			ArchetypeTable& to = *tables[i];
+			const ArchetypeTable& from = *other.tables[i];
+			to.entities = from.entities;
+			to.head = from.head;
+			to.sortedCount = from.sortedCount;
+			for (size_t c = 0; c < to.columns.size(); ++c) to.columns[c]->assign(*from.columns[c]);
+		}
+	}
+	else {
+		tables.clear();
+		for (const auto& t : other.tables) {
+			std::unique_ptr<ArchetypeTable> copy(new ArchetypeTable(resource));
+			copy->types = t->types;
+			copy->entities = t->entities;
+			copy->head = t->head;
+			copy->sortedCount = t->sortedCount;
+			for (const auto& c : t->columns) copy->columns.push_back(c->clone(resource));
+			tables.push_back(std::move(copy));
+		}
+		tableVersion = std::max(tableVersion, other.tableVersion) + 1;
+	}
+	locations = other.locations;
+	freeIndices = other.freeIndices;
+	return *this;
+}
+
+int World::indexOf(const ArchetypeTable& table) const {
+	for (size_t i = 0; i < tables.size(); ++i) if (tables[i].get() == &table) return (int)i;
+	return -1;
+}
+
+Entity World::allocate(int table, uint32_t row) {
+	uint32_t index;
+	if (!freeIndices.empty()) {
+		index = freeIndices.back();
+		freeIndices.pop_back();
+	}
+	else {
+		index = (uint32_t)locations.size();
+		locations.push_back({ -1, 0, 0 });
+	}
+	Location& l = locations[index];
+	l.table = table;
+	l.row = row;
+	return ((Entity)l.generation << 24) | index;
+}
+
+bool World::isAlive(Entity e) const {
+	uint32_t index = e & 0xFFFFFF;
+	return e != NO_ENTITY && index < locations.size() && locations[index].table >= 0 && locations[index].generation == (e >> 24);
+}
+
+void World::destroy(Entity e) {
+	if (!isAlive(e)) return;
+	const Location& l = locations[e & 0xFFFFFF];
+	removeRow(l.table, l.row);
+}
+
+void World::removeRow(int tableIndex, size_t row) {
+	ArchetypeTable& table = *tables[tableIndex];
+	size_t last = table.entities.size() - 1;
+	Entity gone = table.entities[row];
+
+	if (row != last) {
+		Entity moved = table.entities[last];
+		table.entities[row] = moved;
+		for (auto& c : table.columns) c->moveRow(last, row);
+		locations[moved & 0xFFFFFF].row = (uint32_t)row;
+	}
+	table.entities.pop_back();
+	for (auto& c : table.columns) c->popBack();
+	// The moved row joins the unsorted tail, and everything after it with it
+	table.sortedCount = std::min(table.sortedCount, row - table.head);
+
+	Location& l = locations[gone & 0xFFFFFF];
+	l.table = -1;
+	l.generation++;
+	freeIndices.push_back(gone & 0xFFFFFF);
+}
+
+void World::moveRowTo(int tableIndex, size_t from, size_t to) {
+	ArchetypeTable& table = *tables[tableIndex];
+	std::rotate(table.entities.begin() + to, table.entities.begin() + from, table.entities.begin() + from + 1);
+	for (auto& c : table.columns) c->rotateRight(to, from);
+	for (size_t row = to; row <= from; ++row) locations[table.entities[row] & 0xFFFFFF].row = (uint32_t)row;
+}
+
+void World::popFront(int tableIndex, size_t count) {
+	ArchetypeTable& table = *tables[tableIndex];
+	for (size_t row = table.head; row < table.head + count; ++row) {
+		Entity gone = table.entities[row];
+		Location& l = locations[gone & 0xFFFFFF];
+		l.table = -1;
+		l.generation++;
+		freeIndices.push_back(gone & 0xFFFFFF);
+	}
+	table.head += count;
+	table.sortedCount -= std::min(table.sortedCount, count);
+
+	// Compact once the dropped rows outnumber the live ones, so each drop costs O(1) amortized
+	if (table.head < table.size()) return;
+	table.entities.erase(table.entities.begin(), table.entities.begin() + table.head);
+	for (auto& c : table.columns) c->eraseFront(table.head);
+	table.head = 0;
+	for (size_t row = 0; row < table.entities.size(); ++row) locations[table.entities[row] & 0xFFFFFF].row = (uint32_t)row;
+}
+
+void World::applyOrder(int tableIndex, size_t first, const uint32_t* order, size_t count, std::pmr::memory_resource* scratch) {
+	ArchetypeTable& table = *tables[tableIndex];
+	for (auto& c : table.columns) c->reorder(table.head, first, order, count, scratch);
+
+	std::pmr::vector<Entity> sorted(scratch);
+	sorted.reserve(count);
+	for (size_t i = 0; i < count; ++i) sorted.push_back(table.entities[table.head + order[i]]);
+	for (size_t i = 0; i < count; ++i) {
+		size_t row = table.head + first + i;
+		table.entities[row] = sorted[i];
+		locations[sorted[i] & 0xFFFFFF].row = (uint32_t)row;
+	}
+}
+
+void World::clear() {
+	for (auto& t : tables) {
+		for (size_t row = t->head; row < t->entities.size(); ++row) {
+			Location& l = locations[t->entities[row] & 0xFFFFFF];
+			l.table = -1;
+			l.generation++;
+			freeIndices.push_back(t->entities[row] & 0xFFFFFF);
+		}
+		t->entities.clear();
+		for (auto& c : t->columns) c->clear();
+		t->head = 0;
+		t->sortedCount = 0;
+	}
+}
+
+void World::release() {
+	tables.clear();
+	std::pmr::vector<Location>(resource).swap(locations);
+	std::pmr::vector<uint32_t>(resource).swap(freeIndices);
+	++tableVersion;
+}
@@ -0,0 +1,408 @@
+#pragma once
+#include <vector>
+#include <memory_resource>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <atomic>
+
+// Lightweight entity-component storage. Entities with the same set of
+// component types share an archetype table that keeps one dense array per
+// component, so a pass over a component type walks contiguous memory and
+// never touches components it does not ask for. Queries cache which tables
+// match and only rescan when a new table is created.
+//
+// Removal swap-moves the table's last row into the hole, so row order is
+// not stable, but it is deterministic. A table can also be kept sorted by a
+// key: create appends an unsorted tail that sortBy merges in, insertSorted
+// places one row directly, and destroyPrefix then drops everything below a
+// threshold without looking at the rest. Every array comes from the memory
+// resource the World was built with, so a level's entities can live in one
+// arena that is dropped with the level.
+
+typedef uint32_t Entity;
+static const Entity NO_ENTITY = 0xFFFFFFFFu;
+
+typedef int ComponentId;
+
+// Sequential ids, assigned the first time each component type is used
+class ComponentIds {
+	static ComponentId next() { static std::atomic<ComponentId> counter(0); return counter++; }
+public:
+	template <typename T>
+	static ComponentId of() { static const ComponentId id = next(); return id; }
+};
+
+class ComponentColumn {
+public:
+	virtual ~ComponentColumn() {}
+	virtual void moveRow(size_t from, size_t to) = 0;
+	virtual void popBack() = 0;
+	virtual void clear() = 0;
+	virtual void reserve(size_t capacity) = 0;
+	virtual std::unique_ptr<ComponentColumn> clone(std::pmr::memory_resource* resource) const = 0;
+	virtual void assign(const ComponentColumn& other) = 0; // same component type only
+	virtual void eraseFront(size_t count) = 0;
+	virtual void rotateRight(size_t first, size_t last) = 0; // row last moves to first
+	// Rows base + first.. become rows base + order[0..count)
+	virtual void reorder(size_t base, size_t first, const uint32_t* order, size_t count, std::pmr::memory_resource* scratch) = 0;
+};
+
+template <typename T>
+class TypedColumn : public ComponentColumn {
+public:
+	std::pmr::vector<T> items;
+
+	explicit TypedColumn(std::pmr::memory_resource* resource) : items(resource) {}
+
+	void moveRow(size_t from, size_t to) override { items[to] = std::move(items[from]); }
+	void popBack() override { items.pop_back(); }
+	void clear() override { items.clear(); }
+	void reserve(size_t capacity) override { items.reserve(capacity); }
+	std::unique_ptr<ComponentColumn> clone(std::pmr::memory_resource* resource) const override {
+		std::unique_ptr<TypedColumn<T>> copy(new TypedColumn<T>(resource));
+		copy->items = items;
+		return copy;
+	}
+	void assign(const ComponentColumn& other) override { items = static_cast<const TypedColumn<T>&>(other).items; }
+	void eraseFront(size_t count) override { items.erase(items.begin(), items.begin() + count); }
+	void rotateRight(size_t first, size_t last) override {
+		std::rotate(items.begin() + first, items.begin() + last, items.begin() + last + 1);
+	}
+	void reorder(size_t base, size_t first, const uint32_t* order, size_t count, std::pmr::memory_resource* scratch) override {
+		std::pmr::vector<T> sorted(scratch);
+		sorted.reserve(count);
+		for (size_t i = 0; i < count; ++i) sorted.push_back(std::move(items[base + order[i]]));
+		std::move(sorted.begin(), sorted.end(), items.begin() + base + first);
+	}
+};
+
+class ArchetypeTable {
+private:
+	std::vector<ComponentId> types; // sorted
+	std::vector<std::unique_ptr<ComponentColumn>> columns; // same order as types
+	std::pmr::vector<Entity> entities;
+	// Rows before head were dropped by destroyPrefix and are compacted away later;
+	// rows, columns and sizes seen from outside start at head
+	size_t head;
+	size_t sortedCount; // rows from head in the order of the last sortBy key; later rows are the unsorted tail
+
+	friend class World;
+
+public:
+	explicit ArchetypeTable(std::pmr::memory_resource* resource) : entities(resource), head(0), sortedCount(0) {}
+
+	const std::vector<ComponentId>& getTypes() const { return types; }
+	size_t size() const { return entities.size() - head; }
+	Entity getEntity(size_t row) const { return entities[head + row]; }
+
+	bool has(ComponentId id) const { return std::binary_search(types.begin(), types.end(), id); }
+
+	// Dense array of one component; null if this table does not hold it
+	template <typename T>
+	T* column() {
+		ComponentId id = ComponentIds::of<T>();
+		for (size_t i = 0; i < types.size(); ++i) {
+			if (types[i] == id) return static_cast<TypedColumn<T>*>(columns[i].get())->items.data() + head;
+		}
+		return nullptr;
+	}
+	template <typename T>
+	const T* column() const { return const_cast<ArchetypeTable*>(this)->column<T>(); }
+
+private:
+	template <typename T>
+	std::pmr::vector<T>& items() {
+		ComponentId id = ComponentIds::of<T>();
+		size_t i = std::lower_bound(types.begin(), types.end(), id) - types.begin();
+		return static_cast<TypedColumn<T>*>(columns[i].get())->items;
+	}
+};
+
+class World {
+private:
+	// index in the low 24 bits, generation in the high 8 so stale handles are caught
+	struct Location {
+		int table;
+		uint32_t row; // counts the table's dropped head rows too
+		uint8_t generation;
+	};
+
+	std::pmr::memory_resource* resource;
+	std::vector<std::unique_ptr<ArchetypeTable>> tables;
+	std::pmr::vector<Location> locations;
+	std::pmr::vector<uint32_t> freeIndices;
+	uint32_t tableVersion; // bumped whenever a table is added or dropped, to refresh cached queries
+
+public:
+	explicit World(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+	// Copies use the default resource, like std::pmr containers
+	World(const World& other);
+	World& operator=(const World& other);
+
+	template <typename... Cs>
+	Entity create(Cs... components) {
+		ArchetypeTable& table = tableFor<Cs...>();
+		int tableIndex = indexOf(table);
+		Entity e = allocate(tableIndex, (uint32_t)table.entities.size());
+		table.entities.push_back(e);
+		int expand[] = { 0, (table.items<Cs>().push_back(std::move(components)), 0)... };
+		(void)expand;
+		return e;
+	}
+
+	// create, then move the new row to its place by key(const T&) with a binary search,
+	// if the table has no unsorted tail; otherwise it joins the tail for the next sortBy.
+	// For one-off inserts; many per tick are cheaper appended and left to sortBy.
+	template <typename T, typename Key, typename... Cs>
+	Entity insertSorted(Key key, Cs... components) {
+		ArchetypeTable& table = tableFor<Cs...>();
+		bool sorted = table.sortedCount == table.size();
+		Entity e = create(std::move(components)...);
+		if (!sorted) return e;
+
+		T* items = table.column<T>();
+		size_t last = table.size() - 1;
+		auto k = key(items[last]);
+		size_t row = std::upper_bound(items, items + last, k, [&](const decltype(k)& value, const T& item) { return value < key(item); }) - items;
+		if (row != last) moveRowTo(indexOf(table), table.head + last, table.head + row);
+		table.sortedCount = table.size();
+		return e;
+	}
+
+	void destroy(Entity e);
+	bool isAlive(Entity e) const;
+
+	// Drops every entity but keeps the tables and their capacity
+	void clear();
+	// Drops every entity and table and returns all their memory to the resource;
+	// call before resetting an arena the world allocates from
+	void release();
+
+	template <typename T>
+	T* get(Entity e) {
+		if (!isAlive(e)) return nullptr;
+		const Location& l = locations[e & 0xFFFFFF];
+		ArchetypeTable& table = *tables[l.table];
+		T* column = table.column<T>();
+		return column ? column + (l.row - table.head) : nullptr;
+	}
+
+	// Room for capacity entities with exactly these components
+	template <typename... Cs>
+	void reserve(size_t capacity) {
+		ArchetypeTable& table = tableFor<Cs...>();
+		table.entities.reserve(table.head + capacity);
+		int expand[] = { 0, (table.items<Cs>().reserve(table.head + capacity), 0)... };
+		(void)expand;
+	}
+
+	// Entities having T, across every table
+	template <typename T>
+	size_t count() const {
+		size_t total = 0;
+		for (const auto& t : tables) if (t->has(ComponentIds::of<T>())) total += t->size();
+		return total;
+	}
+
+	// Destroys every entity whose T matches pred; returns how many went
+	template <typename T, typename Pred>
+	size_t destroyIf(Pred pred) {
+		size_t removed = 0;
+		for (size_t ti = 0; ti < tables.size(); ++ti) {
+			ArchetypeTable& table = *tables[ti];
+			T* items = table.column<T>();
+			if (!items) continue;
+			for (size_t row = 0; row < table.size();) {
+				if (pred(items[row])) {
+					removeRow((int)ti, table.head + row);
+					items = table.column<T>();
+					++removed;
+				}
+				else {
+					++row;
+				}
+			}
+		}
+		return removed;
+	}
+
+	template <typename T>
+	size_t destroyAll() { return destroyIf<T>([](const T&) { return true; }); }
+
+	// Destroys entities from the front of every table holding T for as long as pred
+	// holds, keeping the order of the rest. On a table sorted by the key pred tests,
+	// that is everything under a threshold, at a cost of the rows dropped.
+	template <typename T, typename Pred>
+	size_t destroyPrefix(Pred pred) {
+		size_t removed = 0;
+		for (size_t ti = 0; ti < tables.size(); ++ti) {
+			ArchetypeTable& table = *tables[ti];
+			T* items = table.column<T>();
+			if (!items) continue;
+			size_t count = 0;
+			while (count < table.size() && pred(items[count])) ++count;
+			if (count > 0) popFront((int)ti, count);
+			removed += count;
+		}
+		return removed;
+	}
+
+	// Brings every table holding T into order by key(const T&), ties by current row.
+	// Only the unsorted tail is sorted; it is then merged into the sorted rows it
+	// overlaps, found by binary search, so appends near the top cost little.
+	// Use one key per component type. Scratch memory comes from scratch.
+	template <typename T, typename Key>
+	void sortBy(Key key, std::pmr::memory_resource* scratch = std::pmr::get_default_resource()) {
+		for (size_t ti = 0; ti < tables.size(); ++ti) {
+			ArchetypeTable& table = *tables[ti];
+			T* items = table.column<T>();
+			size_t sorted = table.sortedCount, count = table.size();
+			if (!items || sorted == count) continue;
+			auto less = [&](uint32_t a, uint32_t b) {
+				auto ka = key(items[a]), kb = key(items[b]);
+				return ka < kb || (!(kb < ka) && a < b);
+			};
+
+			std::pmr::vector<uint32_t> order(count - sorted, scratch);
+			for (size_t i = 0; i < order.size(); ++i) order[i] = (uint32_t)(sorted + i);
+			std::sort(order.begin(), order.end(), less);
+			applyOrder((int)ti, sorted, order.data(), order.size(), scratch);
+
+			auto first = key(items[sorted]);
+			size_t from = std::upper_bound(items, items + sorted, first, [&](const decltype(first)& value, const T& item) { return value < key(item); }) - items;
+			if (from < sorted) {
+				order.resize(count - from);
+				size_t a = from, b = sorted;
+				for (size_t i = 0; i < order.size(); ++i) order[i] = (uint32_t)((b >= count || (a < sorted && !less((uint32_t)b, (uint32_t)a))) ? a++ : b++);
+				applyOrder((int)ti, from, order.data(), order.size(), scratch);
+			}
+			table.sortedCount = count;
+		}
+	}
+
+	// Uncached passes over every entity having all of Cs, for worlds walked once (render snapshots).
+	// Query is the cached form for passes repeated every tick.
+	template <typename... Cs, typename Fn>
+	void each(Fn fn) {
+		for (auto& t : tables) {
+			if (!hasAll<Cs...>(*t)) continue;
+			auto columns = std::make_tuple(t->column<Cs>()...);
+			for (size_t row = 0; row < t->size(); ++row) callRow(fn, columns, row, std::index_sequence_for<Cs...>());
+		}
+	}
+	template <typename... Cs, typename Fn>
+	void eachTable(Fn fn) {
+		for (auto& t : tables) {
+			if (hasAll<Cs...>(*t) && t->size() > 0) fn(t->size(), t->column<Cs>()...);
+		}
+	}
+
+	size_t getTableCount() const { return tables.size(); }
+	ArchetypeTable& getTable(size_t i) { return *tables[i]; }
+	uint32_t getTableVersion() const { return tableVersion; }
+
+private:
+	template <typename... Cs>
+	ArchetypeTable& tableFor() {
+		// On the stack: this runs for every create
+		const size_t n = sizeof...(Cs);
+		ComponentId key[n] = { ComponentIds::of<Cs>()... };
+		std::sort(key, key + n);
+		for (auto& t : tables) {
+			if (t->types.size() == n && std::equal(key, key + n, t->types.begin())) return *t;
+		}
+
+		std::unique_ptr<ArchetypeTable> table(new ArchetypeTable(resource));
+		table->types.assign(key, key + n);
+		table->columns.resize(n);
+		int expand[] = { 0, (table->columns[std::lower_bound(key, key + n, ComponentIds::of<Cs>()) - key].reset(new TypedColumn<Cs>(resource)), 0)... };
+		(void)expand;
+		tables.push_back(std::move(table));
+		++tableVersion;
+		return *tables.back();
+	}
+
+	template <typename... Cs>
+	static bool hasAll(const ArchetypeTable& table) {
+		bool all = true;
+		int expand[] = { 0, (all = all && table.has(ComponentIds::of<Cs>()), 0)... };
+		(void)expand;
+		return all;
+	}
+
+	template <typename Fn, typename Tuple, size_t... I>
+	static void callRow(Fn& fn, Tuple& columns, size_t row, std::index_sequence<I...>) {
+		fn(std::get<I>(columns)[row]...);
+	}
+
+	int indexOf(const ArchetypeTable& table) const;
+	Entity allocate(int table, uint32_t row);
+	// Rows here are physical, counting the table's dropped head rows
+	void removeRow(int table, size_t row);
+	void moveRowTo(int table, size_t from, size_t to); // to < from; rows between shift up one
+	void popFront(int table, size_t count);
+	// Rows first.. (counted from head) become the rows listed in order
+	void applyOrder(int table, size_t first, const uint32_t* order, size_t count, std::pmr::memory_resource* scratch);
+};
+
+// Cached list of the tables holding every one of Cs
+template <typename... Cs>
+class Query {
+private:
+	World& world;
+	uint32_t version;
+	std::vector<ArchetypeTable*> tables;
+
+	void refresh() {
+		if (version == world.getTableVersion()) return;
+		version = world.getTableVersion();
+		tables.clear();
+		for (size_t i = 0; i < world.getTableCount(); ++i) {
+			ArchetypeTable& t = world.getTable(i);
+			bool all = true;
+			int expand[] = { 0, (all = all && t.has(ComponentIds::of<Cs>()), 0)... };
+			(void)expand;
+			if (all) tables.push_back(&t);
+		}
+	}
+
+public:
+	explicit Query(World& w) : world(w), version(0xFFFFFFFFu) {}
+
+	// fn(Cs&...) for every matching entity
+	template <typename Fn>
+	void each(Fn fn) {
+		refresh();
+		for (ArchetypeTable* t : tables) {
+			size_t n = t->size();
+			auto columns = std::make_tuple(t->column<Cs>()...);
+			for (size_t row = 0; row < n; ++row) callRow(fn, columns, row, std::index_sequence_for<Cs...>());
+		}
+	}
+
+	// fn(count, Cs*...) once per matching table, for passes that split the arrays themselves
+	template <typename Fn>
+	void eachTable(Fn fn) {
+		refresh();
+		for (ArchetypeTable* t : tables) {
+			if (t->size() > 0) fn(t->size(), t->column<Cs>()...);
+		}
+	}
+
+	size_t count() {
+		refresh();
+		size_t total = 0;
+		for (ArchetypeTable* t : tables) total += t->size();
+		return total;
+	}
+
+private:
+	template <typename Fn, typename Tuple, size_t... I>
+	static void callRow(Fn& fn, Tuple& columns, size_t row, std::index_sequence<I...>) {
+		fn(std::get<I>(columns)[row]...);
+	}
+};
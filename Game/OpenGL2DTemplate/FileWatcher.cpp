@@ -0,0 +1,96 @@
+#include "FileWatcher.h"
+#include <cstring>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <climits>
+#endif
+
+// Polling fallback checks timestamps once every this many poll() calls
+static const int STAT_POLL_INTERVAL = 30;
+
+static long long modificationTime(const char* path) {
+	struct stat st;
+	if (stat(path, &st) != 0) return 0;
+	return (long long)st.st_mtime;
+}
+
+FileWatcher::FileWatcher() : count(0), notifyFd(-1), pollCounter(0) {
+#ifdef __linux__
+	notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+	if (notifyFd >= 0) close(notifyFd);
+#endif
+}
+
+int FileWatcher::add(const char* path) {
+	if (count >= MAX_WATCHES || strlen(path) >= PATH_LENGTH) return -1;
+
+	Watch& w = watches[count];
+	strcpy(w.path, path);
+	const char* slash = strrchr(w.path, '/');
+	const char* backslash = strrchr(w.path, '\\');
+	if (backslash > slash) slash = backslash;
+	w.name = slash ? slash + 1 : w.path;
+	w.dirWatch = -1;
+	w.lastWrite = modificationTime(path);
+
+#ifdef __linux__
+	if (notifyFd >= 0) {
+		char dir[PATH_LENGTH];
+		if (slash) {
+			size_t len = (size_t)(slash - w.path);
+			memcpy(dir, w.path, len);
+			dir[len] = '\0';
+			if (len == 0) strcpy(dir, "/");
+		}
+		else {
+			strcpy(dir, ".");
+		}
+		w.dirWatch = inotify_add_watch(notifyFd, dir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+	}
+#endif
+	return count++;
+}
+
+unsigned FileWatcher::poll() {
+	unsigned changed = 0;
+
+#ifdef __linux__
+	if (notifyFd >= 0) {
+		alignas(struct inotify_event) char buffer[4096];
+		ssize_t length;
+		while ((length = read(notifyFd, buffer, sizeof(buffer))) > 0) {
+			for (char* p = buffer; p < buffer + length; ) {
+				const struct inotify_event* event = (const struct inotify_event*)p;
+				for (int i = 0; i < count; ++i) {
+					if (watches[i].dirWatch == event->wd && event->len > 0 && strcmp(event->name, watches[i].name) == 0) {
+						changed |= 1u << i;
+					}
+				}
+				p += sizeof(struct inotify_event) + event->len;
+			}
+		}
+	}
+#endif
+
+	// Files without an inotify watch fall back to comparing timestamps
+	if (++pollCounter >= STAT_POLL_INTERVAL) {
+		pollCounter = 0;
+		for (int i = 0; i < count; ++i) {
+			if (watches[i].dirWatch >= 0) continue;
+			long long t = modificationTime(watches[i].path);
+			if (t != watches[i].lastWrite) {
+				watches[i].lastWrite = t;
+				changed |= 1u << i;
+			}
+		}
+	}
+	return changed;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+// Reports edits to a handful of files without blocking or allocating per poll.
+// Linux uses inotify on each file's directory, so editors that save by rename are caught;
+// elsewhere the modification time is compared every few polls.
+class FileWatcher {
+public:
+	static const int MAX_WATCHES = 4;
+	static const int PATH_LENGTH = 260;
+
+private:
+	struct Watch {
+		char path[PATH_LENGTH];
+		const char* name;      // points into path, past the last separator
+		int dirWatch;          // inotify watch descriptor of the directory
+		long long lastWrite;   // modification time for the polling fallback
+	};
+
+	Watch watches[MAX_WATCHES];
+	int count;
+	int notifyFd;
+	int pollCounter;
+
+public:
+	FileWatcher();
+	~FileWatcher();
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	// Returns the watch id (bit index for poll), or -1 if full or the path is too long
+	int add(const char* path);
+
+	// Bitmask of watch ids whose file changed since the last call
+	unsigned poll();
+
+	const char* getPath(int id) const { return watches[id].path; }
+};
@@ -0,0 +1,26 @@
+#include "GLStats.h"
+#include <cstring>
+
+namespace GLStats {
+	GLCounters current[(int)GLStatCategory::Count];
+	GLStatCategory active = GLStatCategory::Other;
+
+	static GLCounters lastFrame[(int)GLStatCategory::Count];
+
+	static const char* const CATEGORY_NAMES[(int)GLStatCategory::Count] = {
+		"Platform", "Collectable", "PowerUp", "Key", "Rock", "Lava", "Player", "Door", "HUD", "Particle", "Other"
+	};
+
+	void endFrame() {
+		memcpy(lastFrame, current, sizeof(current));
+		memset(current, 0, sizeof(current));
+	}
+
+	const GLCounters& getLastFrame(GLStatCategory category) {
+		return lastFrame[(int)category];
+	}
+
+	const char* getCategoryName(GLStatCategory category) {
+		return CATEGORY_NAMES[(int)category];
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <glut.h>
+#include "Profiler.h"
+
+// Optional counting layer over the immediate-mode GL calls used by the entity render() methods.
+// Include after <glut.h> in a .cpp and its GL calls are routed through the counters below.
+// Off unless MOLTEN_GL_STATS is set; follows MOLTEN_PROFILE by default.
+#if !defined(MOLTEN_GL_STATS)
+#if MOLTEN_PROFILE
+#define MOLTEN_GL_STATS 1
+#else
+#define MOLTEN_GL_STATS 0
+#endif
+#endif
+
+enum class GLStatCategory { Platform, Collectable, PowerUp, Key, Rock, Lava, Player, Door, HUD, Particle, Other, Count };
+
+struct GLCounters {
+	unsigned primitives;    // glBegin/glEnd pairs
+	unsigned vertices;
+	unsigned matrixOps;     // push/pop, transforms, mode and identity loads
+	unsigned stateChanges;  // colour, enable/disable, point and line size
+};
+
+namespace GLStats {
+	extern GLCounters current[(int)GLStatCategory::Count];
+	extern GLStatCategory active;
+
+	// Publishes this frame's counters for getLastFrame and clears them; call once per frame
+	void endFrame();
+	const GLCounters& getLastFrame(GLStatCategory category);
+	const char* getCategoryName(GLStatCategory category);
+
+	inline GLCounters& counters() { return current[(int)active]; }
+
+	inline void begin(GLenum mode) { counters().primitives++; ::glBegin(mode); }
+	inline void vertex2f(GLfloat x, GLfloat y) { counters().vertices++; ::glVertex2f(x, y); }
+	inline void vertex3f(GLfloat x, GLfloat y, GLfloat z) { counters().vertices++; ::glVertex3f(x, y, z); }
+	inline void color3f(GLfloat r, GLfloat g, GLfloat b) { counters().stateChanges++; ::glColor3f(r, g, b); }
+	inline void color3fv(const GLfloat* v) { counters().stateChanges++; ::glColor3fv(v); }
+	inline void enable(GLenum cap) { counters().stateChanges++; ::glEnable(cap); }
+	inline void disable(GLenum cap) { counters().stateChanges++; ::glDisable(cap); }
+	inline void pointSize(GLfloat size) { counters().stateChanges++; ::glPointSize(size); }
+	inline void lineWidth(GLfloat width) { counters().stateChanges++; ::glLineWidth(width); }
+	inline void pushMatrix() { counters().matrixOps++; ::glPushMatrix(); }
+	inline void popMatrix() { counters().matrixOps++; ::glPopMatrix(); }
+	inline void translatef(GLfloat x, GLfloat y, GLfloat z) { counters().matrixOps++; ::glTranslatef(x, y, z); }
+	inline void rotatef(GLfloat a, GLfloat x, GLfloat y, GLfloat z) { counters().matrixOps++; ::glRotatef(a, x, y, z); }
+	inline void scalef(GLfloat x, GLfloat y, GLfloat z) { counters().matrixOps++; ::glScalef(x, y, z); }
+	inline void matrixMode(GLenum mode) { counters().matrixOps++; ::glMatrixMode(mode); }
+	inline void loadIdentity() { counters().matrixOps++; ::glLoadIdentity(); }
+	inline void enableClientState(GLenum array) { counters().stateChanges++; ::glEnableClientState(array); }
+	inline void disableClientState(GLenum array) { counters().stateChanges++; ::glDisableClientState(array); }
+	inline void drawArrays(GLenum mode, GLint first, GLsizei count) { counters().primitives++; counters().vertices += count; ::glDrawArrays(mode, first, count); }
+}
+
+// Attributes every GL call in the enclosing scope to one entity type
+class GLStatScope {
+private:
+	GLStatCategory previous;
+
+public:
+	explicit GLStatScope(GLStatCategory category) : previous(GLStats::active) { GLStats::active = category; }
+	~GLStatScope() { GLStats::active = previous; }
+	GLStatScope(const GLStatScope&) = delete;
+	GLStatScope& operator=(const GLStatScope&) = delete;
+};
+
+#if MOLTEN_GL_STATS
+#define GL_STAT_SCOPE(category) GLStatScope PROFILE_CONCAT(glStatScope, __LINE__)(category)
+
+#define glBegin(mode) GLStats::begin(mode)
+#define glVertex2f(x, y) GLStats::vertex2f(x, y)
+#define glVertex3f(x, y, z) GLStats::vertex3f(x, y, z)
+#define glColor3f(r, g, b) GLStats::color3f(r, g, b)
+#define glColor3fv(v) GLStats::color3fv(v)
+#define glEnable(cap) GLStats::enable(cap)
+#define glDisable(cap) GLStats::disable(cap)
+#define glPointSize(size) GLStats::pointSize(size)
+#define glLineWidth(width) GLStats::lineWidth(width)
+#define glPushMatrix() GLStats::pushMatrix()
+#define glPopMatrix() GLStats::popMatrix()
+#define glTranslatef(x, y, z) GLStats::translatef(x, y, z)
+#define glRotatef(a, x, y, z) GLStats::rotatef(a, x, y, z)
+#define glScalef(x, y, z) GLStats::scalef(x, y, z)
+#define glMatrixMode(mode) GLStats::matrixMode(mode)
+#define glLoadIdentity() GLStats::loadIdentity()
+#define glEnableClientState(array) GLStats::enableClientState(array)
+#define glDisableClientState(array) GLStats::disableClientState(array)
+#define glDrawArrays(mode, first, count) GLStats::drawArrays(mode, first, count)
+#else
+#define GL_STAT_SCOPE(category) ((void)0)
+#endif
@@ -1,77 +1,344 @@
 #include "Game.h"
+#include "LevelFile.h"
+#include "Profiler.h"
+#include "GLStats.h"
+#include "JobSystem.h"
+#include "Arena.h"
+#include "AllocStats.h"
+#include <cstdio>
 #include <cstdlib>
 #include <ctime>
 #include <algorithm>
+#include <cmath>
+#include <atomic>
 
 static float frand(float a, float b) { return a + (b - a) * (rand() / (float)RAND_MAX); }
 
-Game::Game(int w, int h)
-	: screenW(w), screenH(h),
+// Chunks kept in the level above the top of the view in endless mode
+static const int ENDLESS_LOOKAHEAD_CHUNKS = 2;
+// Chunks the worker generates beyond those, so taking one rarely waits on it
+static const int ENDLESS_PREFETCH_CHUNKS = 3;
+
+// Entity storage for one level; a rock storm can spill past it into heap chunks
+static const size_t LEVEL_ARENA_BYTES = 4 * 1024 * 1024;
+// Rocks and powerups room made at level start so normal play never grows their tables
+static const size_t ROCK_RESERVE = 256;
+static const size_t POWERUP_RESERVE = 32;
+
+// Minimum entities per job in the parallel passes; smaller vectors stay on the calling thread
+static const size_t PARALLEL_GRAIN = 1024;
+
+// Lava rumble: silent beyond this many units above the lava, loudest at this lava speed
+static const float RUMBLE_RANGE = 450.0f;
+static const float RUMBLE_FULL_SPEED = 40.0f;
+
+// Particle effects
+static const ParticleStyle GEM_BURST = { 0.3f, 0.9f, 1.0f, 60.0f, 180.0f, 0.0f, 360.0f, 0.3f, 0.7f };
+static const ParticleStyle ROCK_DEBRIS = { 0.55f, 0.5f, 0.45f, 80.0f, 220.0f, 20.0f, 160.0f, 0.4f, 0.9f };
+static const ParticleStyle LAVA_SPARK = { 1.0f, 0.55f, 0.1f, 40.0f, 160.0f, 60.0f, 120.0f, 0.4f, 1.0f };
+static const float LAVA_SPARKS_PER_SECOND = 40.0f; // plus this much again per unit of lava speed
+
+// Sort keys: rocks, gems and powerups are kept in order of the height at which the lava takes them
+static float rockKey(const Rock& r) { return r.getY() + r.getHeight(); }
+static float gemKey(const Collectable& c) { return c.getY(); }
+static float powerUpKey(const PowerUp& pu) { return pu.getY(); }
+
+Game::Game(int w, int h, int levelScreens, GameMode gameMode, unsigned seed)
+	: screenW(w), screenH(h), levelHeight((float)h * levelScreens), mode(gameMode),
 	player(w * 0.5f, 40.0f),
 	lava((float)w, 0.0f, 1.0f),
-	door(w * 0.5f, (float)h - 120.0f, 60.0f, 100.0f),
-	hud((float)w, (float)h),
-	key(w * 0.5f, 200.0f),
-	timeSinceStart(0.0f), rockSpawnTimer(0.0f), nextRockSpawn(2.0f), powerupSpawnTimer(0.0f), nextPowerupSpawn(7.0f),
+	door(w * 0.5f, (float)h * levelScreens - 120.0f, 60.0f, 100.0f),
+	hud((float)w, (float)h), hudVisible(true),
+	camera((float)h, (float)h * levelScreens),
+	levelArena(LEVEL_ARENA_BYTES), world(levelArena.getResource()),
+	platforms(world), rocks(world), collectables(world), powerups(world), animatedCollectables(world), animatedPowerups(world), keyEntity(NO_ENTITY), sfxCount(), sfxPan(),
+	nextChunk(0), timeSinceStart(0.0f), rockSpawnTimer(0.0f), nextRockSpawn(2.0f), powerupSpawnTimer(0.0f), nextPowerupSpawn(7.0f),
 	lives(3), score(0), collectedCount(0), keySpawned(false), hasKey(false), state(GameState::Playing),
-	activeAbility(Ability::None), abilityTimeLeft(0.0f), leftHeld(false), rightHeld(false), lavaSpeed(6.0f), lavaAccel(0.3f)
+	activeAbility(Ability::None), abilityTimeLeft(0.0f), leftHeld(false), rightHeld(false), lavaSpeed(0.0f), rockStormRate(0.0f), rockStormBacklog(0.0f), sparkBacklog(0.0f),
+	tuningWatch(-1), levelWatch(-1)
 {
-	srand((unsigned)time(nullptr));
+	if (seed == 0) seed = (unsigned)time(nullptr);
+	srand(seed);
+	keyEntity = world.create(Key(w * 0.5f, 200.0f));
+	if (mode == GameMode::Endless) {
+		// Level grows as chunks arrive; start with just the first screen
+		levelHeight = (float)h;
+		camera.setLevelHeight(levelHeight);
+		streamer.start(seed, (float)w, (float)h);
+		getKey().collect(); // no key or door in endless mode
+	}
 	initLevel();
+	lavaSpeed = tuning.lavaSpeed;
 	lava.setGrowthRate(lavaSpeed);
+	lava.setMaxHeight(levelHeight);
+	hud.setMaxLavaHeight(levelHeight);
+	camera.snapTo(player.getY());
 	Audio::PlayMusic("assets/music_bg.wav");
 }
 
 void Game::initLevel() {
-	platforms.clear();
+	resetWorld();
+	particles.clear();
+
+	if (mode == GameMode::Endless) {
+		// Chunk 0 holds the ground; block on it so the player never starts in mid-air
+		streamer.requestUpTo(ENDLESS_LOOKAHEAD_CHUNKS + ENDLESS_PREFETCH_CHUNKS);
+		streamer.take(incomingChunk);
+		nextChunk = 1;
+		for (const auto& ps : incomingChunk.platforms) world.create(Platform(ps.x, ps.y, ps.width, ps.height));
+		for (const auto& gs : incomingChunk.gems) world.insertSorted<Collectable>(gemKey, Collectable(gs.x, gs.y), CollectableAnimation());
+		levelHeight = incomingChunk.topY;
+		camera.setLevelHeight(levelHeight);
+		return;
+	}
+
 	// at least 3 different sizes; ascending vertical level
-	platforms.emplace_back(screenW * 0.5f, 20.0f, 240.0f, 24.0f); // ground
-	platforms.emplace_back(screenW * 0.25f, 120.0f, 120.0f, 20.0f);
-	platforms.emplace_back(screenW * 0.75f, 220.0f, 160.0f, 20.0f);
-	platforms.emplace_back(screenW * 0.35f, 320.0f, 100.0f, 20.0f);
-	platforms.emplace_back(screenW * 0.65f, 420.0f, 140.0f, 20.0f);
-	platforms.emplace_back(screenW * 0.5f, screenH - 80.0f, 160.0f, 20.0f); // near door
+	world.create(Platform(screenW * 0.5f, 20.0f, 240.0f, 24.0f)); // ground
+	// zig-zag pattern repeated up the whole level height
+	const float rowX[4] = { 0.25f, 0.75f, 0.35f, 0.65f };
+	const float rowW[4] = { 120.0f, 160.0f, 100.0f, 140.0f };
+	int row = 0;
+	for (float py = 120.0f; py <= levelHeight - 180.0f; py += 100.0f, ++row) {
+		world.create(Platform(screenW * rowX[row % 4], py, rowW[row % 4], 20.0f));
+	}
+	world.create(Platform(screenW * 0.5f, levelHeight - 80.0f, 160.0f, 20.0f)); // near door
 
 	// collectables placed without overlap
-	collectables.clear();
-	for (int i = 0; i < 7; ++i) {
+	for (float cy = 80.0f; cy < levelHeight - 150.0f; cy += 60.0f) {
 		float cx = frand(60.0f, screenW - 60.0f);
-		float cy = 80.0f + i * 60.0f;
-		collectables.emplace_back(cx, cy);
+		world.insertSorted<Collectable>(gemKey, Collectable(cx, cy), CollectableAnimation());
+	}
+}
+
+void Game::resetWorld() {
+	// The key carries over; everything else goes back to the arena in one step
+	Key key = getKey();
+	world.release();
+	levelArena.reset();
+	keyEntity = world.create(key);
+	world.reserve<Rock>(ROCK_RESERVE);
+	world.reserve<PowerUp, PowerUpAnimation>(POWERUP_RESERVE);
+}
+
+bool Game::loadLevel(const char* path) {
+	if (mode != GameMode::Classic) return false;
+
+	LevelFile level;
+	if (!level.open(path)) {
+		fprintf(stderr, "%s: %s\n", path, level.getError());
+		return false;
+	}
+	const LevelFileHeader& header = level.getHeader();
+
+	resetWorld();
+
+	world.reserve<Platform>(level.getPlatformCount());
+	const PlatformSpawn* ps = level.getPlatforms();
+	for (uint32_t i = 0; i < level.getPlatformCount(); ++i) world.create(Platform(ps[i].x, ps[i].y, ps[i].width, ps[i].height));
+
+	world.reserve<Collectable, CollectableAnimation>(level.getGemCount());
+	const GemSpawn* gs = level.getGems();
+	// In file order; freeSwallowedEntities sorts them on the first tick
+	for (uint32_t i = 0; i < level.getGemCount(); ++i) world.create(Collectable(gs[i].x, gs[i].y), CollectableAnimation());
+
+	door = Door(header.door.x, header.door.y, header.door.width, header.door.height);
+	keyRule = header.keyRule;
+	tuning = header.tuning;
+	lavaSpeed = tuning.lavaSpeed;
+	lava.setGrowthRate(lavaSpeed);
+
+	levelHeight = header.levelHeight;
+	camera.setLevelHeight(levelHeight);
+	lava.setMaxHeight(levelHeight);
+	hud.setMaxLavaHeight(levelHeight);
+
+	collectedCount = 0;
+	keySpawned = false;
+	hasKey = false;
+	return true;
+}
+
+void Game::enableHotReload(const char* tuningPath, const char* levelPath) {
+	if (tuningPath) {
+		tuningWatch = watcher.add(tuningPath);
+		Tuning loaded = tuning;
+		if (loadTuningFile(tuningPath, loaded)) applyTuning(loaded);
+		else fprintf(stderr, "%s: could not load tuning\n", tuningPath);
+	}
+	if (levelPath) levelWatch = watcher.add(levelPath);
+}
+
+void Game::applyTuning(const Tuning& newTuning) {
+	// Keep the acceleration already accumulated, just shift the base speed
+	lavaSpeed += newTuning.lavaSpeed - tuning.lavaSpeed;
+	lava.setGrowthRate(lavaSpeed);
+	tuning = newTuning;
+
+	// Don't make the player wait out a spawn delay from the old range
+	if (nextRockSpawn > tuning.rockSpawnMax) nextRockSpawn = tuning.rockSpawnMax;
+	if (nextPowerupSpawn > tuning.powerupSpawnMax) nextPowerupSpawn = tuning.powerupSpawnMax;
+}
+
+void Game::applyHotReload() {
+	unsigned changed = watcher.poll();
+	if (!changed) return;
+
+	if (tuningWatch >= 0 && (changed & (1u << tuningWatch))) {
+		Tuning loaded = tuning;
+		if (loadTuningFile(watcher.getPath(tuningWatch), loaded)) applyTuning(loaded);
 	}
+	if (levelWatch >= 0 && (changed & (1u << levelWatch))) {
+		Tuning current = tuning;
+		float currentLavaSpeed = lavaSpeed;
+		if (loadLevel(watcher.getPath(levelWatch)) && tuningWatch >= 0) {
+			// A watched tuning file wins over the tuning baked into the level
+			tuning = current;
+			lavaSpeed = currentLavaSpeed;
+			lava.setGrowthRate(lavaSpeed);
+		}
+	}
+}
+
+void Game::streamChunks() {
+	// Which chunks join the level depends only on the camera, never on how far the
+	// worker has got, so the same seed always plays out the same way
+	int wanted = streamer.chunkIndexAt(camera.getTop()) + ENDLESS_LOOKAHEAD_CHUNKS;
+	streamer.requestUpTo(wanted + ENDLESS_PREFETCH_CHUNKS);
+
+	for (; nextChunk <= wanted; ++nextChunk) {
+		streamer.take(incomingChunk);
+		for (const auto& ps : incomingChunk.platforms) world.create(Platform(ps.x, ps.y, ps.width, ps.height));
+		for (const auto& gs : incomingChunk.gems) world.insertSorted<Collectable>(gemKey, Collectable(gs.x, gs.y), CollectableAnimation());
+		levelHeight = incomingChunk.topY;
+		camera.setLevelHeight(levelHeight);
+		hud.setMaxLavaHeight(levelHeight);
+	}
+}
+
+void Game::freeSwallowedEntities() {
+	float lavaTop = lava.getTopY();
+	float highest = lava.getHighestY();
+	std::pmr::memory_resource* scratch = Arena::frame().getResource();
+
+	// Rocks, gems and powerups are kept sorted by the height the lava takes them at, so what
+	// it has reached is a prefix of each table and the rest is never looked at. sortBy only
+	// has work after creates and swap-removals since the last tick.
+
+	// Rocks are never picked up, so they go as soon as the lava reaches them, with a splash.
+	// They all fall at the same speed, so falling keeps them in order.
+	world.sortBy<Rock>(rockKey, scratch);
+	world.destroyPrefix<Rock>([this, lavaTop](const Rock& r) {
+		if (r.getY() + r.getHeight() >= lavaTop) return false;
+		particles.emit(r.getX(), lavaTop, 3, LAVA_SPARK);
+		return true;
+	});
+
+	// Gems and powerups the lava touches are lost. A flowing surface is uneven, so past the
+	// first dry one some may still be under a lower column; those are hidden until the
+	// prefix reaches them.
+	world.sortBy<Collectable>(gemKey, scratch);
+	world.destroyPrefix<Collectable>([this](const Collectable& c) { return lava.isTouching(c.getX(), c.getY()); });
+	collectables.eachTable([&](size_t count, Collectable* items) {
+		for (size_t i = 0; i < count && items[i].getY() <= highest; ++i) {
+			if (lava.isTouching(items[i].getX(), items[i].getY())) items[i].collect();
+		}
+	});
+
+	// An active powerup still runs its effect timer, so it stays
+	world.sortBy<PowerUp>(powerUpKey, scratch);
+	world.destroyPrefix<PowerUp>([this](const PowerUp& pu) { return !pu.getIsActive() && lava.isTouching(pu.getX(), pu.getY()); });
+	powerups.eachTable([&](size_t count, PowerUp* items) {
+		for (size_t i = 0; i < count && items[i].getY() <= highest; ++i) {
+			if (lava.isTouching(items[i].getX(), items[i].getY())) items[i].remove();
+		}
+	});
 
-	powerups.clear();
-	rocks.clear();
+	if (mode != GameMode::Endless) return;
+
+	// Anything fully under the lava belongs to a chunk that can never be seen again
+	world.destroyIf<Platform>([lavaTop](const Platform& p) { return p.getTop() < lavaTop; });
+	world.destroyIf<PowerUp>([](const PowerUp& pu) { return !pu.getIsVisible() && !pu.getIsActive(); });
 }
 
 void Game::update(float dt) {
 	if (state != GameState::Playing) return;
+	PROFILE_ZONE("Game::update");
+	ALLOC_SCOPE(AllocCategory::Update);
+	Arena::frame().reset();
+	applyHotReload();
 	timeSinceStart += dt;
 
 	// Input movement
-	handlePlayerMovement(dt);
+	{
+		PROFILE_ZONE("handlePlayerMovement");
+		handlePlayerMovement(dt);
+	}
 
 	// Update entities
-	for (auto& p : platforms) p.update(dt);
-	for (auto& r : rocks) {
-		r.setPosition(r.getX(), r.getY() - 120.0f * dt); // falling
+	// Each entity only touches itself, so these split across the job system
+	{
+		PROFILE_ZONE("Platform::update");
+		platforms.eachTable([&](size_t count, Platform* items) {
+			JobSystem::parallelFor(count, JobSystem::grainFor<Platform>(PARALLEL_GRAIN), [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i) items[i].update(dt);
+			});
+		});
+	}
+	{
+		PROFILE_ZONE("Rock fall");
+		float fall = tuning.rockFallSpeed * dt;
+		rocks.eachTable([&](size_t count, Rock* items) {
+			JobSystem::parallelFor(count, JobSystem::grainFor<Rock>(PARALLEL_GRAIN), [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i) items[i].setPosition(items[i].getX(), items[i].getY() - fall); // falling
+			});
+		});
+	}
+	{
+		PROFILE_ZONE("Collectable::update");
+		animatedCollectables.eachTable([&](size_t count, Collectable* items, CollectableAnimation* anims) {
+			JobSystem::parallelFor(count, JobSystem::grainFor<CollectableAnimation>(PARALLEL_GRAIN), [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i) anims[i].update(items[i], dt);
+			});
+		});
+	}
+	{
+		PROFILE_ZONE("PowerUp::update");
+		animatedPowerups.eachTable([&](size_t count, PowerUp* items, PowerUpAnimation* anims) {
+			JobSystem::parallelFor(count, JobSystem::grainFor<PowerUp>(PARALLEL_GRAIN), [&](size_t begin, size_t end) {
+				// Expiry writes the hot record too; its grain also keeps the cold one on whole lines
+				for (size_t i = begin; i < end; ++i) anims[i].update(items[i], dt);
+			});
+		});
 	}
-	for (auto& c : collectables) c.update(dt);
-	for (auto& pu : powerups) pu.update(dt);
-	key.update(dt);
+	getKey().update(dt);
 	player.update(dt);
+	camera.update(player.getY(), dt);
 
 	// Update lava speed (accelerate gradually)
-	lavaSpeed += lavaAccel * dt;
+	lavaSpeed += tuning.lavaAccel * dt;
 	lava.setGrowthRate(lavaSpeed);
 	updateLava(dt);
+	updateRumble();
+
+	if (mode == GameMode::Endless) {
+		PROFILE_ZONE("streamChunks");
+		streamChunks();
+	}
 
 	// Spawn rocks randomly
 	rockSpawnTimer += dt;
 	if (rockSpawnTimer >= nextRockSpawn) {
 		spawnRock();
 		rockSpawnTimer = 0.0f;
-		nextRockSpawn = frand(0.8f, 2.2f);
+		nextRockSpawn = frand(tuning.rockSpawnMin, tuning.rockSpawnMax);
+	}
+	if (rockStormRate > 0.0f) {
+		PROFILE_ZONE("Rock storm spawn");
+		// Spread each tick's batch over the distance a rock falls in one tick so they don't arrive in rows
+		rockStormBacklog += rockStormRate * dt;
+		int count = (int)rockStormBacklog;
+		rockStormBacklog -= count;
+		for (int i = 0; i < count; ++i) spawnRock(frand(0.0f, tuning.rockFallSpeed * dt));
 	}
 
 	// Spawn powerups occasionally (ensure 2 different ones appear during game)
@@ -79,12 +346,35 @@ void Game::update(float dt) {
 	if (powerupSpawnTimer >= nextPowerupSpawn) {
 		spawnPowerUp();
 		powerupSpawnTimer = 0.0f;
-		nextPowerupSpawn = frand(8.0f, 14.0f);
+		nextPowerupSpawn = frand(tuning.powerupSpawnMin, tuning.powerupSpawnMax);
 	}
 
 	// Collisions and game rules
-	checkCollisions(dt);
-	trySpawnKey();
+	{
+		PROFILE_ZONE("checkCollisions");
+		ALLOC_SCOPE(AllocCategory::Collisions);
+		checkCollisions();
+	}
+	{
+		PROFILE_ZONE("resolveEvents");
+		resolveEvents(dt);
+	}
+	{
+		PROFILE_ZONE("freeSwallowedEntities");
+		freeSwallowedEntities();
+	}
+	{
+		PROFILE_ZONE("ParticleSystem::update");
+		sparkBacklog += LAVA_SPARKS_PER_SECOND * (1.0f + lavaSpeed) * dt;
+		int sparks = (int)sparkBacklog;
+		sparkBacklog -= sparks;
+		particles.emitLine(0.0f, (float)screenW, lava.getTopY(), sparks, LAVA_SPARK);
+		particles.update(dt);
+	}
+	if (mode == GameMode::Classic) {
+		PROFILE_ZONE("trySpawnKey");
+		trySpawnKey();
+	}
 
 	// HUD
 	hud.setLives(lives);
@@ -92,127 +382,304 @@ void Game::update(float dt) {
 	hud.setScore(score);
 }
 
+template <class Scene>
+void Game::drawScene(Scene& scene) {
+	PROFILE_ZONE("Game::render");
+	ALLOC_SCOPE(AllocCategory::Render);
+	Arena::frame().reset();
+	World& world = scene.world;
+	glPushMatrix();
+	scene.camera.apply();
+
+	// Cull against the view band before issuing any GL work; margins cover bobbing, pulsing and edges
+	{
+		PROFILE_ZONE("Platform::render");
+		GL_STAT_SCOPE(GLStatCategory::Platform);
+		world.each<Platform>([&](Platform& p) {
+			if (scene.camera.isVisible(p.getBottom() - 4.0f, p.getTop() + 8.0f)) p.render();
+		});
+	}
+	{
+		PROFILE_ZONE("Collectable::render");
+		GL_STAT_SCOPE(GLStatCategory::Collectable);
+		world.each<Collectable, CollectableAnimation>([&](Collectable& c, CollectableAnimation& anim) {
+			if (c.getIsVisible() && scene.camera.isVisible(c.getY() - c.getSize(), c.getY() + c.getSize())) anim.render(c);
+		});
+	}
+	{
+		PROFILE_ZONE("PowerUp::render");
+		GL_STAT_SCOPE(GLStatCategory::PowerUp);
+		world.each<PowerUp, PowerUpAnimation>([&](PowerUp& pu, PowerUpAnimation& anim) {
+			if (pu.getIsVisible() && scene.camera.isVisible(pu.getY() - pu.getSize() * 1.2f, pu.getY() + pu.getSize() * 1.2f)) anim.render(pu);
+		});
+	}
+	{
+		PROFILE_ZONE("Key::render");
+		GL_STAT_SCOPE(GLStatCategory::Key);
+		world.each<Key>([&](Key& k) {
+			if (k.getIsVisible() && scene.camera.isVisible(k.getY() - k.getSize() - 8.0f, k.getY() + k.getSize() + 8.0f)) k.render();
+		});
+	}
+	{
+		PROFILE_ZONE("Rock::render");
+		GL_STAT_SCOPE(GLStatCategory::Rock);
+		world.eachTable<Rock>([&](size_t count, Rock* items) {
+			Rock::renderBatch(items, count, scene.camera.getY(), scene.camera.getTop());
+		});
+	}
+	if (scene.camera.isVisible(scene.lava.getY(), scene.lava.getHighestY() + 10.0f)) {
+		PROFILE_ZONE("Lava::render");
+		GL_STAT_SCOPE(GLStatCategory::Lava);
+		scene.lava.render();
+	}
+	{
+		PROFILE_ZONE("ParticleSystem::render");
+		GL_STAT_SCOPE(GLStatCategory::Particle);
+		scene.particles.render();
+	}
+	{
+		PROFILE_ZONE("Player::render");
+		GL_STAT_SCOPE(GLStatCategory::Player);
+		scene.player.render();
+	}
+	if (scene.mode == GameMode::Classic && scene.camera.isVisible(scene.door.getY(), scene.door.getY() + scene.door.getHeight())) {
+		PROFILE_ZONE("Door::render");
+		GL_STAT_SCOPE(GLStatCategory::Door);
+		scene.door.render();
+	}
+
+	glPopMatrix();
+	if (scene.hudVisible) {
+		PROFILE_ZONE("HUD::render");
+		GL_STAT_SCOPE(GLStatCategory::HUD);
+		scene.hud.render();
+	}
+}
+
 void Game::render() {
-	for (auto& p : platforms) p.render();
-	for (auto& c : collectables) c.render();
-	for (auto& pu : powerups) pu.render();
-	if (key.getIsVisible()) key.render();
-	for (auto& r : rocks) r.render();
-	lava.render();
-	player.render();
-	door.render();
-	hud.render();
+	drawScene(*this);
+}
+
+void Game::renderSnapshot(RenderSnapshot& snapshot) {
+	drawScene(snapshot);
+}
+
+RenderSnapshot Game::snapshot() const {
+	return { mode, state, hudVisible, camera, player, lava, door, hud, world, particles };
+}
+
+void Game::captureSnapshot(RenderSnapshot& out) const {
+	// Member-wise so the arrays keep their capacity between ticks
+	out.mode = mode;
+	out.state = state;
+	out.hudVisible = hudVisible;
+	out.camera = camera;
+	out.player = player;
+	out.lava = lava;
+	out.door = door;
+	out.hud = hud;
+	out.world = world;
+	out.particles = particles;
 }
 
 void Game::handlePlayerMovement(float dt) {
-	float speed = (activeAbility == Ability::Speed) ? 260.0f : 200.0f;
+	float speed = (activeAbility == Ability::Speed) ? tuning.boostSpeed : tuning.walkSpeed;
 	if (leftHeld && !rightHeld) player.setVelocity(-speed, player.getVY());
 	else if (rightHeld && !leftHeld) player.setVelocity(speed, player.getVY());
 	else player.stopHorizontalMovement();
 }
 
-void Game::spawnRock() {
+void Game::spawnRock(float extraHeight) {
 	float x = frand(40.0f, screenW - 40.0f);
 	float sizes[3] = { 40.0f, 55.0f, 70.0f };
 	float s = sizes[rand() % 3];
-	Rock r(x, (float)screenH + 30.0f, s, s * 0.7f);
-	rocks.push_back(r);
+	Rock r(x, camera.getTop() + 30.0f + extraHeight, s, s * 0.7f); // just above the view
+	world.create(r); // joins the unsorted tail; freeSwallowedEntities merges a tick's spawns in one go
 }
 
 void Game::spawnPowerUp() {
 	float x = frand(80.0f, screenW - 80.0f);
-	float y = frand(160.0f, (float)screenH - 120.0f);
+	float y = camera.getY() + frand(160.0f, (float)screenH - 120.0f);
 	PowerUpType t = (rand() % 2 == 0) ? PowerUpType::SPEED_BOOST : PowerUpType::SHIELD; // two types at least once
-	powerups.emplace_back(t, x, y);
+	world.insertSorted<PowerUp>(powerUpKey, PowerUp(t, x, y), PowerUpAnimation(t));
 }
 
-bool Game::aabbOverlap(float ax, float ay, float aw, float ah, float bx, float by, float bw, float bh) {
+bool Game::aabbOverlap(float ax, float ay, float aw, float ah, float bx, float by, float bw, float bh) const {
 	float aL = ax - aw * 0.5f, aR = ax + aw * 0.5f, aB = ay, aT = ay + ah;
 	float bL = bx - bw * 0.5f, bR = bx + bw * 0.5f, bB = by, bT = by + bh;
 	return aR > bL && aL < bR && aT > bB && aB < bT;
 }
 
-void Game::checkCollisions(float dt) {
-	// Player with platforms - grounding
-	bool grounded = false;
-	for (auto& p : platforms) {
-		if (p.isPlayerOnTop(player.getX(), player.getY(), player.getWidth(), player.getHeight())) grounded = true;
-	}
-	player.setGrounded(grounded);
+void Game::checkCollisions() {
+	float px = player.getX(), py = player.getY(), pw = player.getWidth(), ph = player.getHeight();
+	float centerY = py + ph * 0.5f;
 
-	// Player with collectables
-	for (auto& c : collectables) {
-		if (c.getIsVisible() && c.isColliding(player.getX(), player.getY() + player.getHeight() * 0.5f, 12.0f)) {
-			c.collect();
-			score += 10;
-			collectedCount++;
-			Audio::PlaySfx("assets/sfx_collect.wav");
-		}
-	}
+	// Player with platforms - grounding. Any hit grounds the player, so chunk order cannot matter.
+	std::atomic<bool> grounded(false);
+	platforms.eachTable([&](size_t count, Platform* items) {
+		JobSystem::parallelFor(count, JobSystem::grainFor<Platform>(PARALLEL_GRAIN), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				if (items[i].isPlayerOnTop(px, py, pw, ph)) { grounded.store(true, std::memory_order_relaxed); break; }
+			}
+		});
+	});
+	player.setGrounded(grounded.load());
+
+	// Detection only records events; resolveEvents applies them after the pass, so the
+	// loops below have no side effects and split across the job system freely.
+	// The one-per-tick outcomes go first so a full queue can never drop them.
+	events.clear();
+
+	// Lava kills player instantly
+	if (lava.isTouching(px, py)) events.push(GameEventType::LavaKill, 0);
+
+	// Player reaches door top area; only a win with the key
+	if (mode == GameMode::Classic && py + ph > door.getY() && fabs(px - door.getX()) < 60.0f) events.push(GameEventType::DoorReached, 0);
 
 	// Player with key
-	if (key.getIsVisible() && key.isColliding(player.getX(), player.getY() + player.getHeight() * 0.5f, 12.0f)) {
-		key.collect();
-		hasKey = true;
-		Audio::PlaySfx("assets/sfx_key.wav");
-	}
+	Key& key = getKey();
+	if (key.getIsVisible() && key.isColliding(px, centerY, 12.0f)) events.push(GameEventType::KeyCollected, 0);
+
+	// Falling rocks hit player. A storm can put thousands on the player at once, so each
+	// table gives one event: how many hit, and the first of them for the debris.
+	rocks.eachTable([&](size_t count, Rock* items) {
+		std::atomic<uint32_t> hits(0);
+		std::atomic<uint32_t> first(0xFFFFFFFFu);
+		JobSystem::parallelFor(count, JobSystem::grainFor<Rock>(PARALLEL_GRAIN), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				const Rock& r = items[i];
+				if (!aabbOverlap(px, py, pw, ph, r.getX(), r.getY(), r.getWidth(), r.getHeight())) continue;
+				hits.fetch_add(1, std::memory_order_relaxed);
+				uint32_t seen = first.load(std::memory_order_relaxed);
+				while (i < seen && !first.compare_exchange_weak(seen, (uint32_t)i, std::memory_order_relaxed)) {}
+			}
+		});
+		if (hits.load() > 0) events.push(GameEventType::RockHit, first.load(), &items[first.load()], hits.load());
+	});
+
+	// Player with collectables
+	collectables.eachTable([&](size_t count, Collectable* items) {
+		JobSystem::parallelFor(count, JobSystem::grainFor<Collectable>(PARALLEL_GRAIN), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				if (items[i].getIsVisible() && items[i].isColliding(px, centerY, 12.0f)) events.push(GameEventType::GemCollected, (uint32_t)i, &items[i]);
+			}
+		});
+	});
 
 	// Player with powerups
-	for (auto& pu : powerups) {
-		if (pu.getIsVisible() && pu.isColliding(player.getX(), player.getY() + player.getHeight() * 0.5f, 12.0f)) {
-			pu.collect();
-			if (pu.getType() == PowerUpType::SPEED_BOOST) { activeAbility = Ability::Speed; abilityTimeLeft = 8.0f; }
-			if (pu.getType() == PowerUpType::SHIELD) { activeAbility = Ability::Shield; abilityTimeLeft = 8.0f; }
-			Audio::PlaySfx("assets/sfx_powerup.wav");
-		}
-	}
+	powerups.eachTable([&](size_t count, PowerUp* items) {
+		JobSystem::parallelFor(count, JobSystem::grainFor<PowerUp>(PARALLEL_GRAIN), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				if (items[i].getIsVisible() && items[i].isColliding(px, centerY, 12.0f)) events.push(GameEventType::PowerUpTaken, (uint32_t)i, &items[i]);
+			}
+		});
+	});
+
+	// What the lava takes goes in freeSwallowedEntities
+}
+
+void Game::resolveEvents(float dt) {
 	if (activeAbility != Ability::None) {
 		abilityTimeLeft -= dt;
 		if (abilityTimeLeft <= 0.0f) activeAbility = Ability::None;
 	}
 
-	// Falling rocks hit player
-	for (auto& r : rocks) {
-		if (aabbOverlap(player.getX(), player.getY(), player.getWidth(), player.getHeight(), r.getX(), r.getY(), r.getWidth(), r.getHeight())) {
-			if (activeAbility != Ability::Shield) {
-				if (lives > 0) lives -= 1;
-				Audio::PlaySfx("assets/sfx_hit.wav");
+	// Sorted by type then index: the same outcome whatever order the jobs pushed in
+	events.sort();
+
+	// Each sound plays once per tick however many hits asked for it, panned at their mean
+	std::fill(std::begin(sfxCount), std::end(sfxCount), 0);
+	std::fill(std::begin(sfxPan), std::end(sfxPan), 0.0f);
+	auto queueSfx = [&](SoundId id, float x) { sfxCount[(int)id]++; sfxPan[(int)id] += panAt(x); };
+
+	for (size_t i = 0; i < events.size(); ++i) {
+		const GameEvent& e = events[i];
+		switch (e.type) {
+		case GameEventType::GemCollected: {
+			Collectable& c = *e.getGem();
+			c.collect();
+			particles.emit(c.getX(), c.getY(), 24, GEM_BURST);
+			score += 10;
+			collectedCount++;
+			queueSfx(SoundId::Collect, c.getX());
+			break;
+		}
+		case GameEventType::KeyCollected: {
+			Key& key = getKey();
+			key.collect();
+			hasKey = true;
+			queueSfx(SoundId::Key, key.getX());
+			break;
+		}
+		case GameEventType::PowerUpTaken: {
+			PowerUp& pu = *e.getPowerUp();
+			pu.collect();
+			if (pu.getType() == PowerUpType::SPEED_BOOST) { activeAbility = Ability::Speed; abilityTimeLeft = tuning.abilityDuration; }
+			if (pu.getType() == PowerUpType::SHIELD) { activeAbility = Ability::Shield; abilityTimeLeft = tuning.abilityDuration; }
+			queueSfx(SoundId::PowerUp, pu.getX());
+			break;
+		}
+		case GameEventType::RockHit: {
+			const Rock& r = *e.getRock();
+			if (activeAbility != Ability::Shield && state == GameState::Playing) {
+				lives = std::max(0, lives - (int)e.hits); // a life per rock, as when they were resolved one by one
+				particles.emit(r.getX(), r.getY(), 16, ROCK_DEBRIS);
+				queueSfx(SoundId::Hit, r.getX()); // rock X is already its centre
 				if (lives <= 0) lose();
 			}
+			break;
+		}
+		case GameEventType::LavaKill:
+			if (state == GameState::Playing) lose();
+			break;
+		case GameEventType::DoorReached:
+			if (hasKey && state == GameState::Playing) win();
+			break;
 		}
 	}
 
-	// Lava kills player instantly
-	if (lava.isTouching(player.getY())) {
-		lose();
-		Audio::PlaySfx("assets/sfx_lose.wav");
+	for (int id = 0; id < (int)SoundId::Count; ++id) {
+		if (sfxCount[id] > 0) Audio::PlaySfx((SoundId)id, sfxPan[id] / sfxCount[id]);
 	}
 
-	// Lava removes objects it touches
-	for (auto& c : collectables) if (lava.isTouching(c.getY())) c.collect();
-	for (auto& pu : powerups) if (lava.isTouching(pu.getY())) pu.remove();
-	for (auto& r : rocks) if (lava.isTouching(r.getY())) { /* rock disappears */ }
-
 	// Door unlock when player has key
 	if (hasKey) door.unlock();
 	door.update(dt);
-
-	// Win if player reaches door top area
-	if (hasKey && player.getY() + player.getHeight() > screenH - 120.0f && fabs(player.getX() - door.getX()) < 60.0f) {
-		win();
-	}
 }
 
 void Game::updateLava(float dt) {
+	if (lava.isFlowing()) {
+		PROFILE_ZONE("LavaGrid obstacles");
+		LavaGrid& grid = lava.getGrid();
+		grid.follow(lava.getTopY()); // stamp against the band the step will use
+		float bandBottom = grid.getBaseY();
+		float bandTop = bandBottom + LavaGrid::ROWS * LavaGrid::CELL;
+		grid.clearObstacles();
+		platforms.each([&](const Platform& p) {
+			if (p.getTop() >= bandBottom && p.getBottom() <= bandTop) grid.addObstacle(p.getLeft(), p.getBottom(), p.getRight(), p.getTop());
+		});
+	}
 	lava.update(dt);
 	// Lava HUD is driven by height in update()
 }
 
+float Game::panAt(float x) const {
+	return x / screenW * 2.0f - 1.0f;
+}
+
+void Game::updateRumble() {
+	// Closer lava is louder; faster lava raises the floor of how loud it gets
+	float distance = player.getY() - lava.getTopYAt(player.getX());
+	float proximity = std::max(0.0f, std::min(1.0f, 1.0f - distance / RUMBLE_RANGE));
+	float speed = std::min(1.0f, lavaSpeed / RUMBLE_FULL_SPEED);
+	Audio::SetLavaRumble(proximity * (0.3f + 0.7f * speed));
+}
+
 void Game::trySpawnKey() {
-	if (!keySpawned && collectedCount >= 5) {
+	if (!keySpawned && collectedCount >= keyRule.gemsRequired) {
 		// place key above current lava height
-		float safeY = std::max(lava.getTopY() + 80.0f, 200.0f);
-		key.setPosition(screenW * 0.5f, std::min((float)screenH - 120.0f, safeY));
+		float safeY = std::max(lava.getTopY() + keyRule.lavaClearance, keyRule.minY);
+		getKey().setPosition(door.getX(), std::min(door.getY(), safeY));
 		keySpawned = true;
 	}
 }
@@ -220,13 +687,15 @@ void Game::trySpawnKey() {
 void Game::win() {
 	state = GameState::Won;
 	Audio::StopMusic();
-	Audio::PlaySfx("assets/sfx_win.wav");
+	Audio::SetLavaRumble(0.0f);
+	Audio::PlaySfx(SoundId::Win);
 }
 
 void Game::lose() {
 	state = GameState::Lost;
 	Audio::StopMusic();
-	Audio::PlaySfx("assets/sfx_lose.wav");
+	Audio::SetLavaRumble(0.0f);
+	Audio::PlaySfx(SoundId::Lose);
 }
 
 void Game::onKeyDown(unsigned char key) {
@@ -11,17 +11,74 @@
 #include "Door.h"
 #include "HUD.h"
 #include "Audio.h"
+#include "Camera.h"
+#include "ChunkStreamer.h"
+#include "Tuning.h"
+#include "FileWatcher.h"
+#include "ParticleSystem.h"
+#include "Ecs.h"
+#include "Arena.h"
+#include "GameEvents.h"
 
 enum class GameState { Playing, Won, Lost };
 
 enum class Ability { None, Speed, Shield };
 
+// Classic: fixed level with door and key. Endless: chunks streamed ahead of the player forever.
+enum class GameMode { Classic, Endless };
+
+// Copy of everything Game::render draws, taken at the end of a tick so another
+// thread can draw it while the next tick runs. Members mirror Game's.
+struct RenderSnapshot {
+	GameMode mode;
+	GameState state;
+	bool hudVisible;
+	Camera camera;
+	Player player;
+	Lava lava;
+	Door door;
+	HUD hud;
+	World world; // platforms, rocks, collectables, powerups and the key
+	ParticleSystem particles;
+};
+
 class Game {
+	// Benchmarks drive the private passes directly (Benchmarks/SimBenchmarks.cpp, Benchmarks/MoltenBench.cpp)
+	friend struct GameBenchAccess;
+	// Tests set up collisions by hand (Tests/GameTests.cpp)
+	friend struct GameTestAccess;
+
 public:
-	Game(int screenW, int screenH);
+	// levelScreens: level height in multiples of the screen height (Classic only)
+	// seed: 0 picks one from the clock
+	Game(int screenW, int screenH, int levelScreens = 4, GameMode mode = GameMode::Classic, unsigned seed = 0);
 	void update(float dt);
 	void render();
 
+	// Pipelined rendering: the sim thread captures after each update, the render thread draws
+	RenderSnapshot snapshot() const;
+	void captureSnapshot(RenderSnapshot& out) const;
+	static void renderSnapshot(RenderSnapshot& snapshot);
+
+	// Replaces the layout, door, key rule and tuning with a binary level file (Classic only)
+	bool loadLevel(const char* path);
+
+	// Loads tuningPath now, then re-applies it and levelPath between ticks whenever they change on disk.
+	// Either path may be null.
+	void enableHotReload(const char* tuningPath, const char* levelPath);
+
+	// The HUD draws text through GLUT, which needs a window; headless renderers switch it off
+	void setHudVisible(bool visible) { hudVisible = visible; }
+
+	// Grid-simulated lava that flows around platforms instead of rising flat
+	void setLavaFlow(bool enabled) { lava.enableFlow(enabled); }
+
+	// Stress mode: rocks per second on top of the normal spawns, 0 to turn off
+	void setRockStorm(float rocksPerSecond) { rockStormRate = rocksPerSecond; }
+
+	const Tuning& getTuning() const { return tuning; }
+	void setTuning(const Tuning& newTuning) { applyTuning(newTuning); }
+
 	// Input
 	void onKeyDown(unsigned char key);
 	void onKeyUp(unsigned char key);
@@ -30,23 +87,44 @@ public:
 
 	// Accessors
 	GameState getState() const { return state; }
+	GameMode getMode() const { return mode; }
 
 private:
 	int screenW;
 	int screenH;
+	float levelHeight;
+	GameMode mode;
 
 	// Core systems
 	Player player;
 	Lava lava;
 	Door door;
 	HUD hud;
+	bool hudVisible;
+	Camera camera;
+
+	// Entities. Each entity class is a component with its own archetype table;
+	// the queries cache which tables to walk. All of it lives in the level arena.
+	// Gems and powerups carry a hot collision component and a cold animation one;
+	// the collision passes query only the hot arrays.
+	Arena levelArena;
+	World world;
+	Query<Platform> platforms;
+	Query<Rock> rocks;
+	Query<Collectable> collectables;
+	Query<PowerUp> powerups;
+	Query<Collectable, CollectableAnimation> animatedCollectables;
+	Query<PowerUp, PowerUpAnimation> animatedPowerups;
+	Entity keyEntity;
+	ParticleSystem particles;
+	GameEventQueue events; // this tick's collision results, waiting for resolveEvents
+	int sfxCount[(int)SoundId::Count]; // sound requests resolveEvents merged this tick, one voice per id
+	float sfxPan[(int)SoundId::Count];  // sum of those requests' pans
 
-	// Entities
-	std::vector<Platform> platforms;
-	std::vector<Rock> rocks;
-	std::vector<Collectable> collectables;
-	std::vector<PowerUp> powerups;
-	Key key;
+	// Endless mode streaming
+	ChunkStreamer streamer;
+	LevelChunk incomingChunk;
+	int nextChunk; // index of the next chunk to join the level
 
 	// Timers
 	float timeSinceStart;
@@ -55,7 +133,18 @@ private:
 	float powerupSpawnTimer;
 	float nextPowerupSpawn;
 	float lavaSpeed;
-	float lavaAccel;
+	float rockStormRate;
+	float rockStormBacklog; // fractional rocks carried to the next tick
+	float sparkBacklog;     // same for lava sparks
+
+	// Tuning
+	Tuning tuning;
+	KeyRule keyRule;
+
+	// Hot reload
+	FileWatcher watcher;
+	int tuningWatch;
+	int levelWatch;
 
 	// State
 	int lives;
@@ -72,14 +161,24 @@ private:
 	bool rightHeld;
 
 	// Helpers
+	template <class Scene> static void drawScene(Scene& scene); // Game itself or a RenderSnapshot
 	void initLevel();
-	void spawnRock();
+	void resetWorld();
+	Key& getKey() { return *world.get<Key>(keyEntity); }
+	void applyTuning(const Tuning& newTuning);
+	void applyHotReload();
+	void streamChunks();
+	void freeSwallowedEntities();
+	void spawnRock(float extraHeight = 0.0f);
 	void spawnPowerUp();
-	bool aabbOverlap(float ax, float ay, float aw, float ah, float bx, float by, float bw, float bh);
+	bool aabbOverlap(float ax, float ay, float aw, float ah, float bx, float by, float bw, float bh) const;
 	bool placeWithoutOverlap(float x, float y, float w, float h);
-	void checkCollisions(float dt);
+	void checkCollisions(); // detection only; fills events
+	void resolveEvents(float dt);
 	void handlePlayerMovement(float dt);
 	void updateLava(float dt);
+	void updateRumble();
+	float panAt(float x) const; // stereo position of a world X for Audio::PlaySfx
 	void trySpawnKey();
 	void win();
 	void lose();
@@ -0,0 +1,19 @@
+#include "GameEvents.h"
+#include <algorithm>
+#include <functional>
+
+size_t GameEventQueue::size() const {
+	return std::min(count.load(std::memory_order_relaxed), CAPACITY);
+}
+
+void GameEventQueue::sort() {
+	GameEvent* end = events + size();
+	std::sort(events, end, [](const GameEvent& a, const GameEvent& b) {
+		if (a.type != b.type) return a.type < b.type;
+		return a.order != b.order ? a.order < b.order : std::less<void*>()(a.source, b.source); // repeats end up adjacent
+	});
+	end = std::unique(events, end, [](const GameEvent& a, const GameEvent& b) {
+		return a.type == b.type && a.order == b.order && a.source == b.source;
+	});
+	count.store((size_t)(end - events), std::memory_order_relaxed);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+class Collectable;
+class PowerUp;
+class Rock;
+
+// What collision detection found this tick. Detection only records these;
+// Game::resolveEvents applies score, lives, abilities and sounds afterwards.
+enum class GameEventType : uint8_t {
+	GemCollected,
+	KeyCollected,
+	PowerUpTaken,
+	RockHit,
+	LavaKill,
+	DoorReached
+};
+
+struct GameEvent {
+	GameEventType type;
+	uint32_t order; // index in the detecting pass, so resolution order does not depend on threads
+	uint32_t hits;  // entities this event stands for; rock hits come one event per pass
+	void* source;   // the entity hit, if any; which component depends on type
+
+	Collectable* getGem() const { return static_cast<Collectable*>(source); }
+	PowerUp* getPowerUp() const { return static_cast<PowerUp*>(source); }
+	const Rock* getRock() const { return static_cast<const Rock*>(source); }
+};
+
+// Fixed-capacity event list that any number of job threads may push to at once.
+// Events point into the world, so resolve them before the world changes shape.
+// Detection pushes the one-per-tick outcomes (lava, door, key, rock hits) before
+// the per-entity ones, so only gem and powerup events can ever be dropped.
+class GameEventQueue {
+public:
+	static const size_t CAPACITY = 1024;
+
+private:
+	GameEvent events[CAPACITY];
+	std::atomic<size_t> count;
+
+public:
+	GameEventQueue() : count(0) {}
+	GameEventQueue(const GameEventQueue&) = delete;
+	GameEventQueue& operator=(const GameEventQueue&) = delete;
+
+	// Thread-safe; false once full. A dropped hit is seen again by next tick's detection,
+	// though which ones wait depends on the threads, so keep CAPACITY above what a tick can hit.
+	bool push(GameEventType type, uint32_t order, void* source = nullptr, uint32_t hits = 1) {
+		size_t slot = count.fetch_add(1, std::memory_order_relaxed);
+		if (slot >= CAPACITY) return false;
+		GameEvent& e = events[slot];
+		e.type = type;
+		e.order = order;
+		e.hits = hits;
+		e.source = source;
+		return true;
+	}
+
+	// Single-threaded side, after every pusher has finished
+	size_t size() const;
+	const GameEvent& operator[](size_t i) const { return events[i]; }
+	void sort(); // by type, then order; a repeat of the same event is dropped
+	void clear() { count.store(0, std::memory_order_relaxed); }
+};
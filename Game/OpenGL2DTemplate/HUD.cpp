@@ -1,5 +1,6 @@
 #include "HUD.h"
-#include <string>
+#include "GLStats.h"
+#include <cstdio>
 #include <cmath>
 
 
@@ -205,17 +206,18 @@ void HUD::addScore(int points) {
 	score += points;
 }
 
-void HUD::renderText(const std::string& text, float x, float y) {
+void HUD::renderText(const char* text, float x, float y) {
 	glRasterPos2f(x, y);
-	for (char c : text) {
-		glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, c);
+	for (const char* c = text; *c; ++c) {
+		glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
 	}
 }
 
 void HUD::renderNumber(int number, float x, float y) {
-	std::string numStr = std::to_string(number);
+	char numStr[12]; // fits any int
+	snprintf(numStr, sizeof(numStr), "%d", number);
 	glRasterPos2f(x, y);
-	for (char c : numStr) {
-		glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
+	for (const char* c = numStr; *c; ++c) {
+		glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
 	}
 }
\ No newline at end of file
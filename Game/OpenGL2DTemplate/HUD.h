@@ -1,6 +1,5 @@
 #pragma once
 #include <glut.h>
-#include <string>
 
 class HUD {
 private:
@@ -45,6 +44,6 @@ public:
 
 private:
 	void renderHeart(float x, float y, float size, bool filled);
-	void renderText(const std::string& text, float x, float y);
+	void renderText(const char* text, float x, float y);
 	void renderNumber(int number, float x, float y);
 };
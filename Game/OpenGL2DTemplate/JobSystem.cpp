@@ -0,0 +1,147 @@
+#include "JobSystem.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+	struct Job {
+		JobSystem::RangeFn call;
+		const void* fn;
+		size_t begin;
+		size_t end;
+		std::atomic<size_t>* remaining;
+	};
+
+	// Owner pushes and pops at the back; thieves take from the front
+	struct WorkQueue {
+		std::mutex mutex;
+		Job jobs[JobSystem::QUEUE_CAPACITY];
+		size_t head = 0;
+		size_t tail = 0;
+
+		bool push(const Job& job) {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (tail - head == (size_t)JobSystem::QUEUE_CAPACITY) return false;
+			jobs[tail++ % JobSystem::QUEUE_CAPACITY] = job;
+			return true;
+		}
+		bool pop(Job& out) {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (tail == head) return false;
+			out = jobs[--tail % JobSystem::QUEUE_CAPACITY];
+			return true;
+		}
+		bool steal(Job& out) {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (tail == head) return false;
+			out = jobs[head++ % JobSystem::QUEUE_CAPACITY];
+			return true;
+		}
+	};
+
+	// Queue 0 belongs to whichever thread calls parallelFor; 1..workerCount to the workers
+	WorkQueue queues[JobSystem::MAX_WORKERS + 1];
+	std::thread workers[JobSystem::MAX_WORKERS];
+	int workerCount = 0;
+	std::atomic<bool> running(false);
+
+	// Sleeping workers wait here; pending counts queued jobs so nobody sleeps on work
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+	std::atomic<int> pending(0);
+
+	thread_local int queueIndex = 0;
+
+	void execute(const Job& job) {
+		job.call(job.fn, job.begin, job.end);
+		job.remaining->fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	bool findJob(int self, Job& out) {
+		if (queues[self].pop(out)) return true;
+		for (int i = 1; i <= workerCount; ++i) {
+			int victim = (self + i) % (workerCount + 1);
+			if (queues[victim].steal(out)) return true;
+		}
+		return false;
+	}
+
+	void workerLoop(int index) {
+		queueIndex = index;
+		Job job;
+		while (running.load(std::memory_order_relaxed)) {
+			if (findJob(index, job)) {
+				pending.fetch_sub(1, std::memory_order_relaxed);
+				execute(job);
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			wake.wait(lock, [] { return pending.load(std::memory_order_relaxed) > 0 || !running.load(std::memory_order_relaxed); });
+		}
+	}
+}
+
+void JobSystem::init(int count) {
+	shutdown();
+	if (count < 0) count = (int)std::thread::hardware_concurrency() - 1;
+	if (count > MAX_WORKERS) count = MAX_WORKERS;
+	if (count <= 0) return;
+
+	workerCount = count;
+	running = true;
+	for (int i = 0; i < workerCount; ++i) workers[i] = std::thread(workerLoop, i + 1);
+}
+
+void JobSystem::shutdown() {
+	if (!running) return;
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		running = false;
+	}
+	wake.notify_all();
+	for (int i = 0; i < workerCount; ++i) workers[i].join();
+	workerCount = 0;
+}
+
+int JobSystem::getWorkerCount() {
+	return workerCount;
+}
+
+void JobSystem::run(size_t count, size_t grain, RangeFn call, const void* fn) {
+	if (count == 0) return;
+	if (grain == 0) grain = 1;
+
+	size_t chunks = (count + grain - 1) / grain;
+	if (workerCount == 0 || chunks == 1) {
+		for (size_t begin = 0; begin < count; begin += grain) call(fn, begin, begin + grain < count ? begin + grain : count);
+		return;
+	}
+
+	// Deal chunks round-robin so every queue starts with a share; stealing evens out the rest
+	std::atomic<size_t> remaining(chunks);
+	int self = queueIndex;
+	int target = self;
+	for (size_t begin = 0; begin < count; begin += grain) {
+		Job job = { call, fn, begin, begin + grain < count ? begin + grain : count, &remaining };
+		if (queues[target].push(job)) pending.fetch_add(1, std::memory_order_relaxed);
+		else execute(job);
+		target = (target + 1) % (workerCount + 1);
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+	wake.notify_all();
+
+	// Help until our own chunks are done; this may run other callers' chunks too
+	Job job;
+	while (remaining.load(std::memory_order_acquire) > 0) {
+		if (findJob(self, job)) {
+			pending.fetch_sub(1, std::memory_order_relaxed);
+			execute(job);
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+}
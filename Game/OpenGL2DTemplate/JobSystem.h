@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+
+// Small work-stealing job system for data-parallel passes over entity vectors.
+// Each worker owns a queue of range jobs; idle workers steal from the others,
+// and the calling thread works too until its parallelFor has finished.
+//
+// Chunk boundaries depend only on the item count and grain, never on how many
+// threads exist, so as long as each index only writes its own element the
+// result is identical with any thread count (including none).
+class JobSystem {
+public:
+	static const size_t CACHE_LINE = 64;
+	static const int MAX_WORKERS = 15;
+	static const int QUEUE_CAPACITY = 1024; // jobs per worker; overflow runs inline
+
+	typedef void (*RangeFn)(const void* fn, size_t begin, size_t end);
+
+	// workers < 0: one per hardware thread besides the caller. Until this is
+	// called, parallelFor runs every chunk on the calling thread.
+	static void init(int workers = -1);
+	static void shutdown();
+	static int getWorkerCount();
+
+	// Calls fn(begin, end) for consecutive ranges of [0, count), in parallel.
+	// Blocks until every range is done.
+	template <typename Fn>
+	static void parallelFor(size_t count, size_t grain, const Fn& fn) {
+		run(count, grain, [](const void* f, size_t begin, size_t end) { (*(const Fn*)f)(begin, end); }, &fn);
+	}
+
+	// At least minItems of T per chunk, rounded up so each chunk spans whole cache lines
+	template <typename T>
+	static size_t grainFor(size_t minItems) {
+		size_t step = 1;
+		while ((step * sizeof(T)) % CACHE_LINE != 0) ++step;
+		return (minItems + step - 1) / step * step;
+	}
+
+private:
+	static void run(size_t count, size_t grain, RangeFn call, const void* fn);
+};
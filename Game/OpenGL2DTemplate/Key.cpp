@@ -1,23 +1,19 @@
 #include "Key.h"
+#include "GLStats.h"
 #include <cmath>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+// Palette slots
+static const int KEY_COLOR = 0, SHINE_COLOR = 1, SHADOW_COLOR = 2;
+
 Key::Key(float startX, float startY, float size)
 	: x(startX), y(startY), keySize(size),
 	rotationAngle(0.0f), floatAnimation(0.0f), scaleAnimation(1.0f),
-	animationTime(0.0f), isVisible(true)
+	animationTime(0.0f), isVisible(true), material(Material::Key)
 {
-	// Key color (golden)
-	keyColor[0] = 1.0f; keyColor[1] = 0.84f; keyColor[2] = 0.0f;
-
-	// Shine color (bright yellow)
-	shineColor[0] = 1.0f; shineColor[1] = 1.0f; shineColor[2] = 0.7f;
-
-	// Shadow color (dark orange)
-	shadowColor[0] = 0.8f; shadowColor[1] = 0.5f; shadowColor[2] = 0.0f;
 }
 
 void Key::update(float deltaTime) {
@@ -40,6 +36,7 @@ void Key::update(float deltaTime) {
 
 void Key::render() {
 	if (!isVisible) return;
+	const float (*colors)[3] = Palette::get(material).colors;
 
 	glPushMatrix();
 	glTranslatef(x, y + floatAnimation, 0.0f);
@@ -47,7 +44,7 @@ void Key::render() {
 	glScalef(scaleAnimation, scaleAnimation, 1.0f);
 
 	// 1. Key shaft (rectangle/quad)
-	glColor3fv(shadowColor);
+	glColor3fv(colors[SHADOW_COLOR]);
 	float shaftWidth = keySize * 0.15f;
 	float shaftLength = keySize * 0.6f;
 	glBegin(GL_QUADS);
@@ -58,7 +55,7 @@ void Key::render() {
 	glEnd();
 
 	// Key shaft highlight
-	glColor3fv(keyColor);
+	glColor3fv(colors[KEY_COLOR]);
 	glBegin(GL_QUADS);
 	glVertex2f(-shaftWidth / 2, -shaftLength + 2.0f);
 	glVertex2f(shaftWidth / 2 - 1.0f, -shaftLength + 2.0f);
@@ -67,7 +64,7 @@ void Key::render() {
 	glEnd();
 
 	// 2. Key head (circle - triangle fan)
-	glColor3fv(shadowColor);
+	glColor3fv(colors[SHADOW_COLOR]);
 	float headRadius = keySize * 0.25f;
 	glBegin(GL_TRIANGLE_FAN);
 	glVertex2f(0.0f, 0.0f);
@@ -78,7 +75,7 @@ void Key::render() {
 	glEnd();
 
 	// Key head highlight
-	glColor3fv(keyColor);
+	glColor3fv(colors[KEY_COLOR]);
 	glBegin(GL_TRIANGLE_FAN);
 	glVertex2f(-1.5f, 1.5f);
 	for (int i = 0; i <= 20; i++) {
@@ -89,7 +86,7 @@ void Key::render() {
 	glEnd();
 
 	// 3. Key teeth (triangles)
-	glColor3fv(shadowColor);
+	glColor3fv(colors[SHADOW_COLOR]);
 	float toothSize = keySize * 0.08f;
 	
 	// First tooth
@@ -107,7 +104,7 @@ void Key::render() {
 	glEnd();
 
 	// 4. Shine effect (small triangles)
-	glColor3fv(shineColor);
+	glColor3fv(colors[SHINE_COLOR]);
 	float shineSize = keySize * 0.06f;
 	
 	// Shine on head
@@ -1,5 +1,6 @@
 #pragma once
 #include <glut.h>
+#include "Palette.h"
 
 class Key {
 private:
@@ -9,11 +10,6 @@ private:
 
 	// Dimensions
 	float keySize;
-	
-	// Colors
-	float keyColor[3];
-	float shineColor[3];
-	float shadowColor[3];
 
 	// Animation
 	float rotationAngle;
@@ -21,6 +17,7 @@ private:
 	float scaleAnimation;
 	float animationTime;
 	bool isVisible;
+	Material material;
 
 public:
 	// Constructor
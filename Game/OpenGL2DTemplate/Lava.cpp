@@ -1,4 +1,5 @@
 #include "Lava.h"
+#include "GLStats.h"
 #include <cmath>
 
 Lava::Lava(float screenWidth, float startY, float initialHeight)
@@ -25,28 +26,31 @@ void Lava::update(float deltaTime) {
 	bubbleOffset1 = sin(animationTime * 2.0f) * 4.0f;
 	bubbleOffset2 = sin(animationTime * 2.5f + 1.0f) * 3.5f;
 	bubbleOffset3 = sin(animationTime * 3.0f + 2.0f) * 4.5f;
+
+	grid.step(deltaTime, y + height);
 }
 
 void Lava::render() {
 	glPushMatrix();
 
-	// Draw main lava body (quad) - spans full screen width
+	// Draw main lava body (quad) - spans full screen width; when flowing, up to the grid
+	float bodyTop = grid.isEnabled() ? grid.getBaseY() : y + height;
 	glColor3fv(lavaColor);
 	glBegin(GL_QUADS);
 	glVertex2f(x, y);
 	glVertex2f(x + width, y);
-	glVertex2f(x + width, y + height);
-	glVertex2f(x, y + height);
+	glVertex2f(x + width, bodyTop);
+	glVertex2f(x, bodyTop);
 	glEnd();
+	grid.render(lavaColor);
 
 	// Draw animated bubbles across the lava surface
 	glColor3fv(bubbleColor);
 	float bubbleRadius = 5.0f;
-	float bubbleY = y + height - 10.0f;
 
 	// Bubble 1 (left side)
 	float bubble1X = width * 0.2f;
-	float bubble1Y = bubbleY + bubbleOffset1;
+	float bubble1Y = getTopYAt(bubble1X) - 10.0f + bubbleOffset1;
 	glBegin(GL_TRIANGLE_FAN);
 	glVertex2f(bubble1X, bubble1Y);
 	for (int i = 0; i <= 12; i++) {
@@ -57,7 +61,7 @@ void Lava::render() {
 
 	// Bubble 2 (left-center)
 	float bubble2X = width * 0.4f;
-	float bubble2Y = bubbleY + bubbleOffset2;
+	float bubble2Y = getTopYAt(bubble2X) - 10.0f + bubbleOffset2;
 	glBegin(GL_TRIANGLE_FAN);
 	glVertex2f(bubble2X, bubble2Y);
 	for (int i = 0; i <= 12; i++) {
@@ -68,7 +72,7 @@ void Lava::render() {
 
 	// Bubble 3 (right-center)
 	float bubble3X = width * 0.65f;
-	float bubble3Y = bubbleY + bubbleOffset3;
+	float bubble3Y = getTopYAt(bubble3X) - 10.0f + bubbleOffset3;
 	glBegin(GL_TRIANGLE_FAN);
 	glVertex2f(bubble3X, bubble3Y);
 	for (int i = 0; i <= 12; i++) {
@@ -97,6 +101,15 @@ bool Lava::isTouching(float objY) {
 	return verticalOverlap;
 }
 
+bool Lava::isTouching(float objX, float objY) const {
+	return objY <= getTopYAt(objX);
+}
+
+void Lava::enableFlow(bool enabled) {
+	if (enabled) grid.init(x, width, y + height);
+	else grid.disable();
+}
+
 void Lava::setPosition(float newX, float newY) {
 	x = newX;
 	y = newY;
@@ -1,5 +1,6 @@
 #pragma once
 #include <glut.h>
+#include "LavaGrid.h"
 
 class Lava {
 
@@ -20,6 +21,9 @@ private:
 	float bubbleOffset2;
 	float bubbleOffset3;
 
+	// Optional flowing surface; the rectangle still tracks the average level
+	LavaGrid grid;
+
 public:
 	Lava(float screenWidth, float startY = 0.0f, float initialHeight = 1.0f);
 
@@ -30,6 +34,14 @@ public:
 	void setGrowthRate(float rate);
 
 	bool isTouching(float objY);
+	bool isTouching(float objX, float objY) const; // uses the column height when flowing
+
+	// Flow mode: lava pours around and over obstacles instead of rising as a flat sheet
+	void enableFlow(bool enabled);
+	bool isFlowing() const { return grid.isEnabled(); }
+	LavaGrid& getGrid() { return grid; }
+	float getTopYAt(float objX) const { return grid.isEnabled() ? grid.getTopYAt(objX) : getTopY(); }
+	float getHighestY() const { return grid.isEnabled() ? grid.getHighestY() : getTopY(); }
 
 	float getX() const { return x; }
 	float getY() const { return y; }
@@ -0,0 +1,287 @@
+#include "LavaGrid.h"
+#include "GLStats.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LAVA_GRID_SSE2 1
+#endif
+
+// How much extra a full cell holds per full cell stacked on it; gives the flow pressure to climb
+static const float COMPRESSION = 0.02f;
+// Most mass that may cross one edge per pass
+static const float MAX_FLOW = 1.0f;
+// Below this a cell counts as empty for heights and drawing
+static const float MIN_MASS = 0.05f;
+static const int SUBSTEPS = 4;
+// Rows per job; the passes are light, so bands stay large
+static const int BAND_ROWS = 16;
+
+LavaGrid::LavaGrid() : columns(0), stride(0), left(0.0f), baseRow(0) {
+}
+
+void LavaGrid::init(float worldLeft, float worldWidth, float level) {
+	columns = (int)ceilf(worldWidth / CELL);
+	stride = (columns + 2 + 3) & ~3;
+	left = worldLeft;
+	baseRow = (int)floorf(level / CELL) - ROWS_BELOW_LEVEL;
+
+	mass.assign((size_t)ROWS * stride, 0.0f);
+	scratch.assign(mass.size(), 0.0f);
+	open.assign(mass.size(), 0.0f);
+	heights.assign(columns, level);
+	clearObstacles();
+
+	// Fill up to the level, with a partly full top cell
+	float filled = level / CELL - baseRow;
+	for (int row = 0; row < ROWS && row < filled; ++row) {
+		float m = std::min(1.0f, filled - row);
+		for (int c = 0; c < columns; ++c) at(mass, row, c) = m;
+	}
+	measureHeights();
+}
+
+void LavaGrid::disable() {
+	columns = 0;
+	mass.clear();
+	scratch.clear();
+	open.clear();
+	heights.clear();
+}
+
+void LavaGrid::clearObstacles() {
+	for (int row = 0; row < ROWS; ++row) {
+		for (int c = 0; c < columns; ++c) at(open, row, c) = 1.0f;
+	}
+}
+
+void LavaGrid::addObstacle(float x0, float y0, float x1, float y1) {
+	int c0 = std::max(0, (int)floorf((x0 - left) / CELL));
+	int c1 = std::min(columns - 1, (int)floorf((x1 - left) / CELL));
+	int r0 = std::max(0, (int)floorf(y0 / CELL) - baseRow);
+	int r1 = std::min(ROWS - 1, (int)floorf(y1 / CELL) - baseRow);
+	for (int row = r0; row <= r1; ++row) {
+		for (int c = c0; c <= c1; ++c) {
+			at(open, row, c) = 0.0f;
+			at(mass, row, c) = 0.0f; // the top-up in step() replaces anything displaced
+		}
+	}
+}
+
+float LavaGrid::totalMass() const {
+	// Mass caught in a platform's cells can't flow, so it doesn't count towards the level
+	float total = 0.0f;
+	for (size_t i = 0; i < mass.size(); ++i) total += mass[i] * open[i];
+	return total;
+}
+
+float LavaGrid::openVolumeBelow(float level) const {
+	float filled = level / CELL - baseRow;
+	float volume = 0.0f;
+	for (int row = 0; row < ROWS && row < filled; ++row) {
+		const float* openRow = &open[(size_t)row * stride + 1];
+		float openCells = 0.0f;
+		for (int c = 0; c < columns; ++c) openCells += openRow[c];
+		volume += std::min(1.0f, filled - row) * openCells;
+	}
+	return volume;
+}
+
+void LavaGrid::follow(float level) {
+	int wanted = (int)floorf(level / CELL) - ROWS_BELOW_LEVEL;
+	if (wanted < baseRow) {
+		// The level went down (a new level was loaded); start again
+		float worldWidth = (float)columns * CELL;
+		init(left, worldWidth, level);
+		return;
+	}
+	int shift = wanted - baseRow;
+	if (shift == 0) return;
+
+	// Rows leaving the bottom of the band become part of the solid body below it
+	if (shift >= ROWS) {
+		init(left, (float)columns * CELL, level);
+		return;
+	}
+	size_t moved = (size_t)(ROWS - shift) * stride;
+	memmove(mass.data(), mass.data() + (size_t)shift * stride, moved * sizeof(float));
+	std::fill(mass.begin() + moved, mass.end(), 0.0f);
+
+	// Obstacles move with the cells so they stay on their platforms until the next stamp
+	memmove(open.data(), open.data() + (size_t)shift * stride, moved * sizeof(float));
+	for (int row = ROWS - shift; row < ROWS; ++row) {
+		for (int c = 0; c < columns; ++c) at(open, row, c) = 1.0f;
+	}
+	baseRow = wanted;
+}
+
+void LavaGrid::step(float dt, float level) {
+	(void)dt; // the flow runs a fixed number of passes per tick; the level carries the growth
+	if (!isEnabled()) return;
+	follow(level);
+
+	// Top up through the bottom row so the average level tracks the nominal one.
+	// Submerged platforms take up room, so only the open cells below it are owed lava.
+	float deficit = openVolumeBelow(level) - totalMass();
+	if (deficit > 0.0f) {
+		int openCount = 0;
+		for (int c = 0; c < columns; ++c) openCount += at(open, 0, c) > 0.0f;
+		if (openCount > 0) {
+			float share = deficit / openCount;
+			for (int c = 0; c < columns; ++c) {
+				if (at(open, 0, c) > 0.0f) at(mass, 0, c) += share;
+			}
+		}
+	}
+
+	for (int i = 0; i < SUBSTEPS; ++i) {
+		// Alternate row pairs so no cell is in two exchanges in the same pass
+		flowVertical(0);
+		flowVertical(1);
+		flowHorizontal();
+	}
+	measureHeights();
+}
+
+void LavaGrid::flowVertical(int parity) {
+	int pairs = (ROWS - parity) / 2;
+	JobSystem::parallelFor(pairs, BAND_ROWS / 2, [&](size_t begin, size_t end) {
+		for (size_t p = begin; p < end; ++p) {
+			int row = (int)p * 2 + parity;
+			float* lower = &mass[(size_t)row * stride];
+			float* upper = lower + stride;
+			const float* openLower = &open[(size_t)row * stride];
+			const float* openUpper = openLower + stride;
+
+			// Mass the lower cell of a stacked pair should end up with, given their total:
+			// all of it up to one cell, then a little more the more is stacked above
+			int j = 0;
+#ifdef LAVA_GRID_SSE2
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 compression = _mm_set1_ps(COMPRESSION);
+			const __m128 invOnePlusC = _mm_set1_ps(1.0f / (1.0f + COMPRESSION));
+			const __m128 half = _mm_set1_ps(0.5f);
+			const __m128 maxFlow = _mm_set1_ps(MAX_FLOW);
+			for (; j + 4 <= stride; j += 4) {
+				__m128 l = _mm_loadu_ps(lower + j);
+				__m128 u = _mm_loadu_ps(upper + j);
+				__m128 total = _mm_add_ps(l, u);
+				__m128 squeezed = _mm_mul_ps(_mm_add_ps(one, _mm_mul_ps(total, compression)), invOnePlusC);
+				__m128 shared = _mm_mul_ps(_mm_add_ps(total, compression), half);
+				__m128 stable = _mm_max_ps(one, _mm_max_ps(squeezed, shared));
+				__m128 flow = _mm_sub_ps(stable, l);
+				flow = _mm_min_ps(flow, _mm_min_ps(u, maxFlow));
+				flow = _mm_max_ps(flow, _mm_max_ps(_mm_sub_ps(zero, l), _mm_sub_ps(zero, maxFlow)));
+				flow = _mm_mul_ps(flow, _mm_mul_ps(_mm_loadu_ps(openLower + j), _mm_loadu_ps(openUpper + j)));
+				_mm_storeu_ps(lower + j, _mm_add_ps(l, flow));
+				_mm_storeu_ps(upper + j, _mm_sub_ps(u, flow));
+			}
+#endif
+			for (; j < stride; ++j) {
+				float total = lower[j] + upper[j];
+				float stable = std::max(1.0f, std::max((1.0f + total * COMPRESSION) / (1.0f + COMPRESSION), (total + COMPRESSION) * 0.5f));
+				float flow = std::min(stable - lower[j], std::min(upper[j], MAX_FLOW));
+				flow = std::max(flow, std::max(-lower[j], -MAX_FLOW));
+				flow *= openLower[j] * openUpper[j];
+				lower[j] += flow;
+				upper[j] -= flow;
+			}
+		}
+	});
+}
+
+void LavaGrid::flowHorizontal() {
+	// Each open pair of neighbours moves a quarter of their difference; symmetric, so mass is kept
+	JobSystem::parallelFor(ROWS, BAND_ROWS, [&](size_t begin, size_t end) {
+		for (size_t row = begin; row < end; ++row) {
+			const float* m = &mass[row * stride];
+			const float* o = &open[row * stride];
+			float* out = &scratch[row * stride];
+			out[0] = m[0];
+			out[stride - 1] = m[stride - 1];
+
+			int j = 1;
+#ifdef LAVA_GRID_SSE2
+			const __m128 quarter = _mm_set1_ps(0.25f);
+			for (; j + 4 <= stride - 1; j += 4) {
+				__m128 centre = _mm_loadu_ps(m + j);
+				__m128 oc = _mm_loadu_ps(o + j);
+				__m128 toLeft = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(m + j - 1), centre), _mm_loadu_ps(o + j - 1));
+				__m128 toRight = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(m + j + 1), centre), _mm_loadu_ps(o + j + 1));
+				__m128 change = _mm_mul_ps(_mm_mul_ps(_mm_add_ps(toLeft, toRight), oc), quarter);
+				_mm_storeu_ps(out + j, _mm_add_ps(centre, change));
+			}
+#endif
+			for (; j < stride - 1; ++j) {
+				float change = ((m[j - 1] - m[j]) * o[j - 1] + (m[j + 1] - m[j]) * o[j + 1]) * o[j] * 0.25f;
+				out[j] = m[j] + change;
+			}
+		}
+	});
+	mass.swap(scratch);
+}
+
+void LavaGrid::measureHeights() {
+	float base = getBaseY();
+	for (int c = 0; c < columns; ++c) {
+		heights[c] = base;
+		for (int row = ROWS - 1; row >= 0; --row) {
+			float m = at(mass, row, c);
+			if (m >= MIN_MASS) {
+				heights[c] = base + (row + std::min(m, 1.0f)) * CELL;
+				break;
+			}
+		}
+	}
+}
+
+float LavaGrid::getTopYAt(float worldX) const {
+	int c = (int)floorf((worldX - left) / CELL);
+	c = std::max(0, std::min(columns - 1, c));
+	return heights[c];
+}
+
+float LavaGrid::getHighestY() const {
+	float highest = getBaseY();
+	for (float h : heights) highest = std::max(highest, h);
+	return highest;
+}
+
+void LavaGrid::render(const float* color) {
+	if (!isEnabled()) return;
+
+	// Full cells merge into runs along each row; partly full cells are drawn at their fill height.
+	// Only the render thread draws, so the vertex array is kept between frames.
+	static std::vector<GLfloat> quads;
+	quads.clear();
+	float base = getBaseY();
+	for (int row = 0; row < ROWS; ++row) {
+		float bottom = base + row * CELL;
+		int c = 0;
+		while (c < columns) {
+			float m = at(mass, row, c);
+			if (m < MIN_MASS) { ++c; continue; }
+
+			int runStart = c;
+			float top = bottom + std::min(m, 1.0f) * CELL;
+			if (m >= 1.0f) {
+				while (c + 1 < columns && at(mass, row, c + 1) >= 1.0f) ++c;
+			}
+			float x0 = left + runStart * CELL, x1 = left + (c + 1) * CELL;
+			const GLfloat quad[8] = { x0, bottom, x1, bottom, x1, top, x0, top };
+			quads.insert(quads.end(), quad, quad + 8);
+			++c;
+		}
+	}
+	if (quads.empty()) return;
+
+	glColor3fv(color);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, quads.data());
+	glDrawArrays(GL_QUADS, 0, (GLsizei)(quads.size() / 2));
+	glDisableClientState(GL_VERTEX_ARRAY);
+}
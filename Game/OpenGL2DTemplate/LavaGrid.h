@@ -0,0 +1,61 @@
+#pragma once
+#include <glut.h>
+#include <vector>
+
+// Cellular-automaton lava that flows around and over platforms. A band of
+// cells follows the lava surface; everything below the band counts as solid
+// lava. Each cell holds a mass (1 = full, slightly more when compressed
+// from above).
+//
+// Every pass reads the previous state and writes disjoint cells, so rows are
+// processed four columns per SSE2 instruction and split into bands across
+// the job system with the same result on any thread count.
+class LavaGrid {
+public:
+	static const int CELL = 8;             // world units per cell
+	static const int ROWS = 96;            // band height in cells
+	static const int ROWS_BELOW_LEVEL = 16; // band rows kept under the nominal level
+
+private:
+	int columns;    // playable columns
+	int stride;     // columns plus a wall on each side, rounded up to a multiple of four
+	float left;     // world X of the first playable column
+	int baseRow;    // world row index of band row 0
+
+	std::vector<float> mass;
+	std::vector<float> scratch;
+	std::vector<float> open;    // 1 where lava may flow, 0 for walls and platforms
+	std::vector<float> heights; // per column, world Y of the highest molten cell's top
+
+public:
+	LavaGrid();
+
+	bool isEnabled() const { return columns > 0; }
+	void init(float worldLeft, float worldWidth, float level);
+	void disable();
+
+	// Moves the band to sit under level. Call before stamping obstacles, since a
+	// level that went down starts the grid again and clears them.
+	void follow(float level);
+
+	// Platforms are re-stamped before every step
+	void clearObstacles();
+	void addObstacle(float x0, float y0, float x1, float y1);
+
+	// Tops up the mass so the average level matches level, then lets it flow
+	void step(float dt, float level);
+
+	float getBaseY() const { return (float)(baseRow * CELL); }
+	float getTopYAt(float worldX) const;
+	float getHighestY() const;
+
+	void render(const float* color);
+
+private:
+	float& at(std::vector<float>& v, int row, int column) { return v[row * stride + column + 1]; }
+	float totalMass() const;
+	float openVolumeBelow(float level) const;
+	void flowVertical(int parity);
+	void flowHorizontal();
+	void measureHeights();
+};
@@ -0,0 +1,149 @@
+#include "LavaRumble.h"
+#include <chrono>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LAVA_RUMBLE_SSE2 1
+#endif
+
+// Fraction of each buffer's playback time the rumble may spend generating it
+static const float CPU_BUDGET = 0.1f;
+// Buffers comfortably under budget before stepping quality back up
+static const int RECOVER_BUFFERS = 200;
+
+static const float PI = 3.14159265f;
+
+LavaRumble::LavaRumble() : target(0.0f), intensity(0.0f), quality(2), buffersUnderBudget(0), budgetSeconds(0.0f) {
+	init(44100, 512);
+}
+
+void LavaRumble::init(int sampleRate, int bufferFrames) {
+	static const float NOISE_CUTOFF_HZ[LANES] = { 40.0f, 80.0f, 160.0f, 320.0f };
+	static const float NOISE_GAIN[LANES] = { 9000.0f, 6000.0f, 3000.0f, 1200.0f };
+	static const float OSC_HZ[LANES] = { 29.0f, 37.0f, 46.0f, 58.0f };
+	static const float OSC_GAIN[LANES] = { 2200.0f, 1800.0f, 1400.0f, 1000.0f };
+
+	for (int i = 0; i < LANES; ++i) {
+		noiseState[i] = 0x9E3779B9u * (i + 1);
+		lowpass[i] = 0.0f;
+		cutoff[i] = 1.0f - expf(-2.0f * PI * NOISE_CUTOFF_HZ[i] / sampleRate);
+		noiseGain[i] = NOISE_GAIN[i];
+
+		float w = 2.0f * PI * OSC_HZ[i] / sampleRate;
+		oscCos[i] = 1.0f;
+		oscSin[i] = 0.0f;
+		oscStepCos[i] = cosf(w);
+		oscStepSin[i] = sinf(w);
+		oscGain[i] = OSC_GAIN[i];
+	}
+	quality = 2;
+	buffersUnderBudget = 0;
+	budgetSeconds = CPU_BUDGET * bufferFrames / sampleRate;
+}
+
+void LavaRumble::tick(float& left, float& right) {
+#ifdef LAVA_RUMBLE_SSE2
+	// xorshift32 on four lanes at once
+	__m128i s = _mm_load_si128((const __m128i*)noiseState);
+	s = _mm_xor_si128(s, _mm_slli_epi32(s, 13));
+	s = _mm_xor_si128(s, _mm_srli_epi32(s, 17));
+	s = _mm_xor_si128(s, _mm_slli_epi32(s, 5));
+	_mm_store_si128((__m128i*)noiseState, s);
+	__m128 noise = _mm_mul_ps(_mm_cvtepi32_ps(s), _mm_set1_ps(1.0f / 2147483648.0f));
+
+	// One-pole low-pass per band
+	__m128 lp = _mm_load_ps(lowpass);
+	lp = _mm_add_ps(lp, _mm_mul_ps(_mm_load_ps(cutoff), _mm_sub_ps(noise, lp)));
+	_mm_store_ps(lowpass, lp);
+
+	// Rotate each oscillator's phasor by its step
+	__m128 c = _mm_load_ps(oscCos), sn = _mm_load_ps(oscSin);
+	__m128 sc = _mm_load_ps(oscStepCos), ss = _mm_load_ps(oscStepSin);
+	__m128 nc = _mm_sub_ps(_mm_mul_ps(c, sc), _mm_mul_ps(sn, ss));
+	__m128 ns = _mm_add_ps(_mm_mul_ps(c, ss), _mm_mul_ps(sn, sc));
+	_mm_store_ps(oscCos, nc);
+	_mm_store_ps(oscSin, ns);
+
+	__m128 bands = _mm_mul_ps(lp, _mm_load_ps(noiseGain));
+	__m128 tones = _mm_mul_ps(ns, _mm_load_ps(oscGain));
+
+	// Noise bands spread evenly; odd oscillators lean left, even ones right
+	alignas(16) float b[LANES], t[LANES];
+	_mm_store_ps(b, bands);
+	_mm_store_ps(t, tones);
+	float noiseSum = b[0] + b[1] + b[2] + b[3];
+	left = noiseSum + t[0] + t[2] * 0.5f + t[1] * 0.5f;
+	right = noiseSum + t[1] + t[3] * 0.5f + t[2] * 0.5f;
+#else
+	float b[LANES], t[LANES];
+	for (int i = 0; i < LANES; ++i) {
+		uint32_t x = noiseState[i];
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		noiseState[i] = x;
+		float noise = (int32_t)x * (1.0f / 2147483648.0f);
+		lowpass[i] += cutoff[i] * (noise - lowpass[i]);
+
+		float c = oscCos[i], s = oscSin[i];
+		oscCos[i] = c * oscStepCos[i] - s * oscStepSin[i];
+		oscSin[i] = c * oscStepSin[i] + s * oscStepCos[i];
+
+		b[i] = lowpass[i] * noiseGain[i];
+		t[i] = oscSin[i] * oscGain[i];
+	}
+	float noiseSum = b[0] + b[1] + b[2] + b[3];
+	left = noiseSum + t[0] + t[2] * 0.5f + t[1] * 0.5f;
+	right = noiseSum + t[1] + t[3] * 0.5f + t[2] * 0.5f;
+#endif
+}
+
+void LavaRumble::renormalise() {
+	// Keep the phasors on the unit circle; float rounding slowly drifts them
+	for (int i = 0; i < LANES; ++i) {
+		float scale = 1.0f / sqrtf(oscCos[i] * oscCos[i] + oscSin[i] * oscSin[i]);
+		oscCos[i] *= scale;
+		oscSin[i] *= scale;
+	}
+}
+
+void LavaRumble::mixInto(int32_t* accumulator, int frames) {
+	float wanted = target.load(std::memory_order_relaxed);
+	if (wanted < 0.0f) wanted = 0.0f;
+	if (wanted > 1.0f) wanted = 1.0f;
+	if (quality == 0 || (wanted <= 0.0f && intensity <= 0.0f)) {
+		intensity = wanted;
+		if (quality == 0 && ++buffersUnderBudget >= RECOVER_BUFFERS) {
+			quality = 1;
+			buffersUnderBudget = 0;
+		}
+		return;
+	}
+
+	auto started = std::chrono::steady_clock::now();
+
+	// Ramp across the buffer so intensity changes do not click
+	float gain = intensity;
+	float gainStep = (wanted - intensity) / frames;
+	float left = 0.0f, right = 0.0f;
+	for (int frame = 0; frame < frames; ++frame) {
+		// At half rate every other frame repeats the previous output
+		if (quality == 2 || (frame & 1) == 0) tick(left, right);
+		accumulator[frame * 2] += (int32_t)(left * gain);
+		accumulator[frame * 2 + 1] += (int32_t)(right * gain);
+		gain += gainStep;
+	}
+	intensity = wanted;
+	renormalise();
+
+	float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - started).count();
+	if (elapsed > budgetSeconds) {
+		--quality;
+		buffersUnderBudget = 0;
+	}
+	else if (quality < 2 && elapsed < budgetSeconds * 0.25f && ++buffersUnderBudget >= RECOVER_BUFFERS) {
+		++quality;
+		buffersUnderBudget = 0;
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+
+// Procedural lava rumble: four bands of low-passed noise plus four low
+// oscillators, each set of four processed as one SIMD vector. Runs on the
+// mixer thread and halves its sample rate (or mutes) when a buffer takes
+// longer than its CPU budget.
+class LavaRumble {
+public:
+	static const int LANES = 4;
+
+private:
+	std::atomic<float> target; // 0..1, written by the game thread
+	float intensity;           // smoothed towards target once per buffer
+
+	// Per-lane DSP state; arrays of four so they map onto one vector register
+	alignas(16) uint32_t noiseState[LANES];
+	alignas(16) float lowpass[LANES];
+	alignas(16) float cutoff[LANES];
+	alignas(16) float noiseGain[LANES];
+	alignas(16) float oscCos[LANES];
+	alignas(16) float oscSin[LANES];
+	alignas(16) float oscStepCos[LANES];
+	alignas(16) float oscStepSin[LANES];
+	alignas(16) float oscGain[LANES];
+
+	int quality;          // 2 = full rate, 1 = half rate, 0 = muted
+	int buffersUnderBudget;
+	float budgetSeconds;
+
+public:
+	LavaRumble();
+
+	void init(int sampleRate, int bufferFrames);
+
+	// Game thread: how loud the rumble should be, 0..1
+	void setIntensity(float value) { target.store(value, std::memory_order_relaxed); }
+
+	// Mixer thread: adds frames of interleaved stereo to the accumulator
+	void mixInto(int32_t* accumulator, int frames);
+
+	int getQuality() const { return quality; }
+
+private:
+	// Advances every lane one sample and returns the summed left and right outputs
+	void tick(float& left, float& right);
+	void renormalise();
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <vector>
+
+// Plain spawn data for one horizontal slice of a streamed level.
+// Built off the main thread; Game turns it into entities.
+struct PlatformSpawn {
+	float x;
+	float y;
+	float width;
+	float height;
+};
+
+struct GemSpawn {
+	float x;
+	float y;
+};
+
+struct LevelChunk {
+	int index;
+	float bottomY;
+	float topY;
+	std::vector<PlatformSpawn> platforms;
+	std::vector<GemSpawn> gems;
+};
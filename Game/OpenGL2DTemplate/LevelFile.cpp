@@ -0,0 +1,139 @@
+#include "LevelFile.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <type_traits>
+
+static_assert(sizeof(PlatformSpawn) == 16 && sizeof(GemSpawn) == 8, "level records must stay packed");
+static_assert(std::is_trivially_copyable<LevelFileHeader>::value, "header is read straight from the mapping");
+static_assert(sizeof(LevelFileHeader) % 4 == 0, "records after the header must stay 4-byte aligned");
+
+LevelFile::LevelFile() : header(nullptr), platforms(nullptr), gems(nullptr) {
+	error[0] = '\0';
+}
+
+bool LevelFile::fail(const char* message) {
+	snprintf(error, sizeof(error), "%s", message);
+	close();
+	return false;
+}
+
+// True if count records of recordSize starting at offset lie inside the file
+static bool rangeFits(size_t fileSize, uint32_t offset, uint32_t count, size_t recordSize) {
+	if (offset % 4 != 0 || offset > fileSize) return false;
+	return (uint64_t)count * recordSize <= fileSize - offset;
+}
+
+bool LevelFile::open(const char* path) {
+	close();
+	if (!file.open(path)) return fail("cannot map level file");
+	if (file.getSize() < sizeof(LevelFileHeader)) return fail("level file truncated");
+
+	const LevelFileHeader* h = (const LevelFileHeader*)file.getData();
+	if (h->magic != LEVEL_FILE_MAGIC) return fail("not a level file");
+	if (h->version != LEVEL_FILE_VERSION || h->headerSize != sizeof(LevelFileHeader)) return fail("unsupported level file version");
+	if (!rangeFits(file.getSize(), h->platformOffset, h->platformCount, sizeof(PlatformSpawn))) return fail("platform table out of range");
+	if (!rangeFits(file.getSize(), h->gemOffset, h->gemCount, sizeof(GemSpawn))) return fail("gem table out of range");
+
+	header = h;
+	platforms = (const PlatformSpawn*)(file.getData() + h->platformOffset);
+	gems = (const GemSpawn*)(file.getData() + h->gemOffset);
+	error[0] = '\0';
+	return true;
+}
+
+void LevelFile::close() {
+	file.close();
+	header = nullptr;
+	platforms = nullptr;
+	gems = nullptr;
+}
+
+bool LevelFile::convertText(const char* textPath, const char* binaryPath, char* error, size_t errorSize) {
+	FILE* in = fopen(textPath, "r");
+	if (!in) {
+		snprintf(error, errorSize, "cannot open %s", textPath);
+		return false;
+	}
+
+	LevelFileHeader h = {};
+	h.magic = LEVEL_FILE_MAGIC;
+	h.version = LEVEL_FILE_VERSION;
+	h.headerSize = sizeof(LevelFileHeader);
+	h.levelHeight = 600.0f;
+	h.door = { 400.0f, 480.0f, 60.0f, 100.0f };
+	h.keyRule = KeyRule();
+	h.tuning = Tuning();
+	bool doorSet = false;
+
+	std::vector<PlatformSpawn> platformList;
+	std::vector<GemSpawn> gemList;
+
+	char line[256];
+	int lineNumber = 0;
+	bool ok = true;
+	while (ok && fgets(line, sizeof(line), in)) {
+		++lineNumber;
+		char* comment = strchr(line, '#');
+		if (comment) *comment = '\0';
+
+		char keyword[32];
+		int consumed = 0;
+		if (sscanf(line, " %31s %n", keyword, &consumed) != 1) continue; // blank line
+		const char* args = line + consumed;
+
+		if (strcmp(keyword, "platform") == 0) {
+			PlatformSpawn p;
+			ok = sscanf(args, "%f %f %f %f", &p.x, &p.y, &p.width, &p.height) == 4;
+			if (ok) platformList.push_back(p);
+		}
+		else if (strcmp(keyword, "gem") == 0) {
+			GemSpawn g;
+			ok = sscanf(args, "%f %f", &g.x, &g.y) == 2;
+			if (ok) gemList.push_back(g);
+		}
+		else if (strcmp(keyword, "level_height") == 0) {
+			ok = sscanf(args, "%f", &h.levelHeight) == 1;
+		}
+		else if (strcmp(keyword, "door") == 0) {
+			ok = sscanf(args, "%f %f %f %f", &h.door.x, &h.door.y, &h.door.width, &h.door.height) == 4;
+			doorSet = ok;
+		}
+		else if (strcmp(keyword, "key_rule") == 0) {
+			ok = sscanf(args, "%d %f %f", &h.keyRule.gemsRequired, &h.keyRule.minY, &h.keyRule.lavaClearance) == 3;
+		}
+		else if (strcmp(keyword, "tuning") == 0) {
+			char name[64];
+			float value;
+			ok = sscanf(args, "%63s %f", name, &value) == 2 && setTuningValue(h.tuning, name, value);
+		}
+		else {
+			ok = false;
+		}
+
+		if (!ok) snprintf(error, errorSize, "%s:%d: bad '%s' record", textPath, lineNumber, keyword);
+	}
+	fclose(in);
+	if (!ok) return false;
+	if (!doorSet) h.door.y = h.levelHeight - 120.0f;
+
+	h.platformCount = (uint32_t)platformList.size();
+	h.platformOffset = sizeof(LevelFileHeader);
+	h.gemCount = (uint32_t)gemList.size();
+	h.gemOffset = h.platformOffset + h.platformCount * (uint32_t)sizeof(PlatformSpawn);
+
+	FILE* out = fopen(binaryPath, "wb");
+	if (!out) {
+		snprintf(error, errorSize, "cannot create %s", binaryPath);
+		return false;
+	}
+	bool written = fwrite(&h, sizeof(h), 1, out) == 1;
+	if (written && !platformList.empty()) written = fwrite(platformList.data(), sizeof(PlatformSpawn), platformList.size(), out) == platformList.size();
+	if (written && !gemList.empty()) written = fwrite(gemList.data(), sizeof(GemSpawn), gemList.size(), out) == gemList.size();
+	if (fclose(out) != 0) written = false;
+	if (!written) {
+		snprintf(error, errorSize, "failed writing %s", binaryPath);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "LevelChunk.h"
+#include "MappedFile.h"
+#include "Tuning.h"
+
+// Binary level layout, native endianness, every record 4-byte aligned:
+//   LevelFileHeader | PlatformSpawn[platformCount] | GemSpawn[gemCount]
+// Bump LEVEL_FILE_VERSION whenever any of these structs change.
+static const uint32_t LEVEL_FILE_MAGIC = 0x4C564C4D; // "MLVL"
+static const uint32_t LEVEL_FILE_VERSION = 1;
+
+struct DoorSpawn {
+	float x;
+	float y;
+	float width;
+	float height;
+};
+
+struct LevelFileHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t headerSize;
+	uint32_t platformCount;
+	uint32_t platformOffset;
+	uint32_t gemCount;
+	uint32_t gemOffset;
+	float levelHeight;
+	DoorSpawn door;
+	KeyRule keyRule;
+	Tuning tuning;
+};
+
+// A memory-mapped level. The accessors point straight into the mapping, so
+// loading does no parsing and no allocation; they stay valid until close().
+class LevelFile {
+private:
+	MappedFile file;
+	const LevelFileHeader* header;
+	const PlatformSpawn* platforms;
+	const GemSpawn* gems;
+	char error[128];
+
+public:
+	LevelFile();
+
+	bool open(const char* path);
+	void close();
+	bool isOpen() const { return header != nullptr; }
+	const char* getError() const { return error; }
+
+	const LevelFileHeader& getHeader() const { return *header; }
+	const PlatformSpawn* getPlatforms() const { return platforms; }
+	uint32_t getPlatformCount() const { return header->platformCount; }
+	const GemSpawn* getGems() const { return gems; }
+	uint32_t getGemCount() const { return header->gemCount; }
+
+	// Converts the human-readable form to a binary level. Text format, one record per line, '#' comments:
+	//   level_height H | door X Y W H | key_rule GEMS MIN_Y CLEARANCE | tuning NAME VALUE
+	//   platform X Y W H | gem X Y
+	static bool convertText(const char* textPath, const char* binaryPath, char* error, size_t errorSize);
+
+private:
+	bool fail(const char* message);
+};
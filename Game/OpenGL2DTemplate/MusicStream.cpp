@@ -0,0 +1,59 @@
+#include "MusicStream.h"
+
+MusicStream::MusicStream() : step(1.0), position(0.0), readIndex(0), writeIndex(0) {
+	format = { 0, 0, 0, nullptr, 0 };
+}
+
+bool MusicStream::open(const char* path, int sampleRate) {
+	close();
+	if (!file.open(path)) return false;
+	if (!parseWav(file.getData(), file.getSize(), format)) {
+		close();
+		return false;
+	}
+	step = (double)format.sampleRate / sampleRate;
+	rewind();
+	return true;
+}
+
+void MusicStream::close() {
+	file.close();
+	format = { 0, 0, 0, nullptr, 0 };
+}
+
+void MusicStream::rewind() {
+	position = 0.0;
+	readIndex = 0;
+	writeIndex = 0;
+}
+
+void MusicStream::fill() {
+	if (!format.data) return;
+
+	// Indices run freely; their difference is the number of buffered frames
+	while (writeIndex - readIndex < (uint32_t)RING_FRAMES) {
+		uint32_t a = (uint32_t)position;
+		uint32_t b = a + 1 < format.frames ? a + 1 : 0; // interpolate across the loop point
+		double t = position - a;
+
+		int left = (int)(wavSample(format, a, 0) * (1.0 - t) + wavSample(format, b, 0) * t);
+		int right = format.channels == 2 ? (int)(wavSample(format, a, 1) * (1.0 - t) + wavSample(format, b, 1) * t) : left;
+
+		int16_t* out = &ring[(writeIndex & (RING_FRAMES - 1)) * 2];
+		out[0] = (int16_t)left;
+		out[1] = (int16_t)right;
+		++writeIndex;
+
+		position += step;
+		if (position >= format.frames) position -= format.frames;
+	}
+}
+
+void MusicStream::mixInto(int32_t* accumulator, int frames, int gain) {
+	for (int frame = 0; frame < frames && readIndex != writeIndex; ++frame) {
+		const int16_t* in = &ring[(readIndex & (RING_FRAMES - 1)) * 2];
+		accumulator[frame * 2] += (in[0] * gain) >> 8;
+		accumulator[frame * 2 + 1] += (in[1] * gain) >> 8;
+		++readIndex;
+	}
+}
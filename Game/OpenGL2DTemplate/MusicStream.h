@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include "MappedFile.h"
+#include "WavLoader.h"
+
+// Looping music played straight out of a memory-mapped WAV. Frames are
+// converted to the mixer format a little ahead of playback into a small
+// ring, so a track of any length costs RING_FRAMES of memory.
+class MusicStream {
+public:
+	static const int RING_FRAMES = 4096; // power of two, ~93 ms at 44.1 kHz
+
+private:
+	MappedFile file;
+	WavFormat format;
+	double step;     // source frames per output frame
+	double position; // next source frame to convert
+
+	int16_t ring[RING_FRAMES * 2]; // interleaved stereo
+	uint32_t readIndex;
+	uint32_t writeIndex;
+
+public:
+	MusicStream();
+
+	// Maps the file; the mixer must not be reading this stream while it is reopened
+	bool open(const char* path, int sampleRate);
+	void close();
+	bool isOpen() const { return file.isOpen(); }
+
+	// Mixer thread only
+	void rewind();
+	void fill();
+	void mixInto(int32_t* accumulator, int frames, int gain);
+};
@@ -0,0 +1,22 @@
+#include "Palette.h"
+
+static const Palette PALETTES[(int)Material::Count] = {
+	// Platform: stone gray base, darker edge, lighter decoration
+	{ { { 0.6f, 0.6f, 0.6f }, { 0.4f, 0.4f, 0.4f }, { 0.8f, 0.8f, 0.8f } } },
+	// Gem: blue crystal, white sparkle, dark blue base
+	{ { { 0.2f, 0.6f, 1.0f }, { 1.0f, 1.0f, 1.0f }, { 0.1f, 0.3f, 0.5f } } },
+	// Speed boost: lightning yellow/orange
+	{ { { 1.0f, 0.9f, 0.0f }, { 1.0f, 0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f } } },
+	// Shield: blue/purple
+	{ { { 0.2f, 0.4f, 1.0f }, { 0.6f, 0.2f, 0.9f }, { 0.8f, 0.8f, 1.0f } } },
+	// Key: golden, bright yellow shine, dark orange shadow
+	{ { { 1.0f, 0.84f, 0.0f }, { 1.0f, 1.0f, 0.7f }, { 0.8f, 0.5f, 0.0f } } },
+	// Rock
+	{ { { 0.5f, 0.5f, 0.5f } } },
+	// Player: head, torso, legs, arms, cap
+	{ { { 1.0f, 0.85f, 0.7f }, { 0.2f, 0.4f, 0.8f }, { 0.9f, 0.75f, 0.6f }, { 0.9f, 0.75f, 0.6f }, { 1.0f, 0.0f, 0.0f } } },
+};
+
+const Palette& Palette::get(Material material) {
+	return PALETTES[(int)material];
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+
+// Colour sets shared by every entity of a material. Entities keep a one-byte
+// material id and look their colours up here instead of each carrying its own
+// copies of the same constants.
+enum class Material : uint8_t { Platform, Gem, SpeedBoost, Shield, Key, Rock, Player, Count };
+
+struct Palette {
+	static const int MAX_COLORS = 5;
+
+	// What each slot is for depends on the material; the entity classes name them
+	float colors[MAX_COLORS][3];
+
+	static const Palette& get(Material material);
+};
@@ -0,0 +1,132 @@
+#include "ParticleSystem.h"
+#include "GLStats.h"
+#include <cmath>
+#include <algorithm>
+#include <initializer_list>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLES_SSE2 1
+#endif
+
+ParticleSystem::ParticleSystem(float gravityY) : count(0), gravity(gravityY), rngState(0x2545F491u) {
+	// Full size up front so emitting never allocates; a rock storm alone peaks near 60000
+	for (auto* v : { &x, &y, &vx, &vy, &life, &invSpan, &r, &g, &b }) v->reserve(MAX_PARTICLES);
+}
+
+ParticleSystem::ParticleSystem(const ParticleSystem& other) : ParticleSystem(other.gravity) {
+	*this = other; // vector assignment keeps the reserve
+}
+
+float ParticleSystem::random(float a, float b) {
+	// Own generator so effects never shift the game's rand() sequence
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return a + (b - a) * ((rngState >> 8) * (1.0f / 16777216.0f));
+}
+
+size_t ParticleSystem::grow(int amount) {
+	size_t first = count;
+	if (amount <= 0) return first;
+	count = std::min(MAX_PARTICLES, count + (size_t)amount);
+	for (auto* v : { &x, &y, &vx, &vy, &life, &invSpan, &r, &g, &b }) v->resize(count);
+	return first;
+}
+
+void ParticleSystem::spawn(size_t i, float originX, float originY, const ParticleStyle& style) {
+	float angle = random(style.angleMin, style.angleMax) * 0.0174533f;
+	float speed = random(style.speedMin, style.speedMax);
+	float span = random(style.lifeMin, style.lifeMax);
+	x[i] = originX;
+	y[i] = originY;
+	vx[i] = cosf(angle) * speed;
+	vy[i] = sinf(angle) * speed;
+	life[i] = span;
+	invSpan[i] = 1.0f / span;
+	r[i] = style.r;
+	g[i] = style.g;
+	b[i] = style.b;
+}
+
+void ParticleSystem::emit(float originX, float originY, int amount, const ParticleStyle& style) {
+	for (size_t i = grow(amount); i < count; ++i) spawn(i, originX, originY, style);
+}
+
+void ParticleSystem::emitLine(float left, float right, float originY, int amount, const ParticleStyle& style) {
+	for (size_t i = grow(amount); i < count; ++i) spawn(i, random(left, right), originY, style);
+}
+
+void ParticleSystem::kill(size_t i) {
+	size_t last = --count;
+	x[i] = x[last];
+	y[i] = y[last];
+	vx[i] = vx[last];
+	vy[i] = vy[last];
+	life[i] = life[last];
+	invSpan[i] = invSpan[last];
+	r[i] = r[last];
+	g[i] = g[last];
+	b[i] = b[last];
+}
+
+void ParticleSystem::update(float dt) {
+	size_t i = 0;
+#ifdef PARTICLES_SSE2
+	__m128 step = _mm_set1_ps(dt);
+	__m128 pull = _mm_set1_ps(gravity * dt);
+	for (; i + 4 <= count; i += 4) {
+		__m128 pvy = _mm_add_ps(_mm_loadu_ps(&vy[i]), pull);
+		_mm_storeu_ps(&vy[i], pvy);
+		_mm_storeu_ps(&x[i], _mm_add_ps(_mm_loadu_ps(&x[i]), _mm_mul_ps(_mm_loadu_ps(&vx[i]), step)));
+		_mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&y[i]), _mm_mul_ps(pvy, step)));
+		_mm_storeu_ps(&life[i], _mm_sub_ps(_mm_loadu_ps(&life[i]), step));
+	}
+#endif
+	for (; i < count; ++i) {
+		vy[i] += gravity * dt;
+		x[i] += vx[i] * dt;
+		y[i] += vy[i] * dt;
+		life[i] -= dt;
+	}
+
+	// Swap-remove; the particle moved in is checked again before moving on
+	for (size_t j = 0; j < count;) {
+		if (life[j] <= 0.0f) kill(j);
+		else ++j;
+	}
+	for (auto* v : { &x, &y, &vx, &vy, &life, &invSpan, &r, &g, &b }) v->resize(count);
+}
+
+void ParticleSystem::clear() {
+	count = 0;
+	for (auto* v : { &x, &y, &vx, &vy, &life, &invSpan, &r, &g, &b }) v->clear(); // keeps the reserve
+}
+
+void ParticleSystem::render() {
+	if (count == 0) return;
+
+	// Only the render thread draws, so the interleaving buffers are kept between frames
+	static std::vector<GLfloat> positions;
+	static std::vector<GLfloat> colors;
+	positions.resize(count * 2);
+	colors.resize(count * 3);
+	for (size_t i = 0; i < count; ++i) {
+		float fade = life[i] * invSpan[i];
+		positions[i * 2] = x[i];
+		positions[i * 2 + 1] = y[i];
+		colors[i * 3] = r[i] * fade;
+		colors[i * 3 + 1] = g[i] * fade;
+		colors[i * 3 + 2] = b[i] * fade;
+	}
+
+	glPointSize(3.0f);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, positions.data());
+	glColorPointer(3, GL_FLOAT, 0, colors.data());
+	glDrawArrays(GL_POINTS, 0, (GLsizei)count);
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glPointSize(1.0f);
+}
@@ -1,22 +1,18 @@
 #include "Platform.h"
+#include "GLStats.h"
 #include <cmath>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+// Palette slots
+static const int BASE_COLOR = 0, EDGE_COLOR = 1, DECOR_COLOR = 2;
+
 Platform::Platform(float startX, float startY, float platformWidth, float platformHeight)
 	: x(startX), y(startY), width(platformWidth), height(platformHeight),
-	animationTime(0.0f), bobOffset(0.0f), isVisible(true)
+	animationTime(0.0f), bobOffset(0.0f), isVisible(true), material(Material::Platform)
 {
-	// Base platform color (stone gray)
-	baseColor[0] = 0.6f; baseColor[1] = 0.6f; baseColor[2] = 0.6f;
-
-	// Edge color (darker gray)
-	edgeColor[0] = 0.4f; edgeColor[1] = 0.4f; edgeColor[2] = 0.4f;
-
-	// Decoration color (lighter gray)
-	decorColor[0] = 0.8f; decorColor[1] = 0.8f; decorColor[2] = 0.8f;
 }
 
 void Platform::update(float deltaTime) {
@@ -30,12 +26,13 @@ void Platform::update(float deltaTime) {
 
 void Platform::render() {
 	if (!isVisible) return;
+	const float (*colors)[3] = Palette::get(material).colors;
 
 	glPushMatrix();
 	glTranslatef(x, y + bobOffset, 0.0f);
 
 	// 1. Main platform body (quad/rectangle)
-	glColor3fv(baseColor);
+	glColor3fv(colors[BASE_COLOR]);
 	glBegin(GL_QUADS);
 	glVertex2f(-width / 2, 0.0f);
 	glVertex2f(width / 2, 0.0f);
@@ -44,7 +41,7 @@ void Platform::render() {
 	glEnd();
 
 	// 2. Platform edges/borders (quads for depth)
-	glColor3fv(edgeColor);
+	glColor3fv(colors[EDGE_COLOR]);
 	float edgeThickness = 3.0f;
 
 	// Top edge
@@ -72,7 +69,7 @@ void Platform::render() {
 	glEnd();
 
 	// 3. Decorative elements (triangular supports)
-	glColor3fv(decorColor);
+	glColor3fv(colors[DECOR_COLOR]);
 	float supportSize = height * 0.6f;
 	float supportSpacing = width / 4.0f;
 
@@ -104,7 +101,7 @@ void Platform::render() {
 	glEnd();
 
 	// 4. Surface texture/pattern (small quads)
-	glColor3f(decorColor[0] * 0.9f, decorColor[1] * 0.9f, decorColor[2] * 0.9f);
+	glColor3f(colors[DECOR_COLOR][0] * 0.9f, colors[DECOR_COLOR][1] * 0.9f, colors[DECOR_COLOR][2] * 0.9f);
 	float tileSize = 8.0f;
 	int tilesX = (int)(width / tileSize);
 	
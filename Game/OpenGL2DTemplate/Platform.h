@@ -1,5 +1,6 @@
 #pragma once
 #include <glut.h>
+#include "Palette.h"
 
 class Platform {
 private:
@@ -9,15 +10,12 @@ private:
 
 	float width;
 	float height;
-	
-	float baseColor[3];
-	float edgeColor[3];
-	float decorColor[3];
 
 	float animationTime;
 	float bobOffset;
 
 	bool isVisible;
+	Material material;
 
 public:
 
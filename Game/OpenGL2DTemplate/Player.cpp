@@ -1,17 +1,16 @@
 #include "Player.h"
+#include "GLStats.h"
 #include <cmath>
 
+// Palette slots
+static const int HEAD_COLOR = 0, TORSO_COLOR = 1, LEG_COLOR = 2, ARM_COLOR = 3, CAP_COLOR = 4;
+
 Player::Player(float startX, float startY)
 	: x(startX), y(startY), vx(0), vy(0),
 	headRadius(15.0f), torsoWidth(20.0f), torsoHeight(30.0f),
 	armWidth(5.0f), armLength(20.0f), legWidth(5.0f), legLength(25.0f),
-	capSize(10.0f), jumpOffset(0.0f), isJumping(false
+	capSize(10.0f), jumpOffset(0.0f), isJumping(false), material(Material::Player)
 {
-	headColor[0] = 1.0f; headColor[1] = 0.85f; headColor[2] = 0.7f;
-	torsoColor[0] = 0.2f; torsoColor[1] = 0.4f; torsoColor[2] = 0.8f;
-	legColor[0] = 0.9f; legColor[1] = 0.75f; legColor[2] = 0.6f;
-	armColor[0] = 0.9f; armColor[1] = 0.75f; armColor[2] = 0.6f;
-	capColor[0] = 1.0f; capColor[1] = 0.0f; capColor[2] = 0.0f;
 }
 
 void Player::update(float deltaTime) {
@@ -32,6 +31,8 @@ void Player::update(float deltaTime) {
 }
 
 void Player::render() {
+	const float (*colors)[3] = Palette::get(material).colors;
+
 	glPushMatrix();
 	glTranslatef(x, y + jumpOffset, 0.0f);
 
@@ -44,7 +45,7 @@ void Player::render() {
 	float capBottom = headCenter + headRadius * 0.5f;
 
 	// Draw Legs
-	glColor3fv(legColor);
+	glColor3fv(colors[LEG_COLOR]);
 	float legOffset = torsoWidth * 0.25f;
 
 	// Left leg
@@ -64,7 +65,7 @@ void Player::render() {
 	glEnd();
 
 	// Draw torso
-	glColor3fv(torsoColor);
+	glColor3fv(colors[TORSO_COLOR]);
 	glBegin(GL_QUADS);
 	glVertex2f(-torsoWidth / 2, torsoBottom);
 	glVertex2f(torsoWidth / 2, torsoBottom);
@@ -73,7 +74,7 @@ void Player::render() {
 	glEnd();
 
 	// Draw arms 
-	glColor3fv(armColor);
+	glColor3fv(colors[ARM_COLOR]);
 	float armOffset = torsoWidth / 2 + armWidth / 2;
 	float armY = torsoTop - 5.0f;
 
@@ -94,7 +95,7 @@ void Player::render() {
 	glEnd();
 
 	// Draw head 
-	glColor3fv(headColor);
+	glColor3fv(colors[HEAD_COLOR]);
 	glBegin(GL_TRIANGLE_FAN);
 	glVertex2f(0.0f, headCenter);  
 	for (int i = 0; i <= 20; i++) {
@@ -115,7 +116,7 @@ void Player::render() {
 	glEnd();
 
 	// Draw cap 
-	glColor3fv(capColor);
+	glColor3fv(colors[CAP_COLOR]);
 	glBegin(GL_TRIANGLES);
 	glVertex2f(-capSize / 2, capBottom);
 	glVertex2f(capSize / 2, capBottom);
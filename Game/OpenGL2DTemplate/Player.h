@@ -1,5 +1,6 @@
 #pragma once
 #include <glut.h>
+#include "Palette.h"
 
 class Player {
 
@@ -22,14 +23,9 @@ private:
 	float legLength;
 	float capSize;
 
-	float headColor[3];
-	float torsoColor[3];
-	float legColor[3];
-	float armColor[3];
-	float capColor[3];
-
 	float jumpOffset;
 	bool isJumping;
+	Material material;
 
 public:
 	Player(float startX, float startY);
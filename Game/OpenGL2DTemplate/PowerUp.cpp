@@ -1,33 +1,30 @@
 #include "PowerUp.h"
+#include "GLStats.h"
 #include <cmath>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+// Palette slots
+static const int PRIMARY_COLOR = 0, SECONDARY_COLOR = 1, ACCENT_COLOR = 2;
+
 PowerUp::PowerUp(PowerUpType powerType, float startX, float startY, float powerSize)
 	: type(powerType), x(startX), y(startY), size(powerSize),
-	duration(8.0f), lifeTime(15.0f), remainingLife(15.0f),
+	isVisible(true), isActive(false)
+{
+}
+
+PowerUpAnimation::PowerUpAnimation(PowerUpType powerType)
+	: duration(8.0f), lifeTime(15.0f), remainingLife(15.0f),
 	rotationAngle(0.0f), scaleAnimation(1.0f), pulseAnimation(0.0f),
-	animationTime(0.0f), isVisible(true), isActive(false)
+	animationTime(0.0f),
+	material(powerType == PowerUpType::SHIELD ? Material::Shield : Material::SpeedBoost)
 {
-	switch (type) {
-	case PowerUpType::SPEED_BOOST:
-		// Lightning/Speed - Yellow/Orange
-		primaryColor[0] = 1.0f; primaryColor[1] = 0.9f; primaryColor[2] = 0.0f;
-		secondaryColor[0] = 1.0f; secondaryColor[1] = 0.5f; secondaryColor[2] = 0.0f;
-		accentColor[0] = 1.0f; accentColor[1] = 1.0f; accentColor[2] = 1.0f;
-		break;
-	case PowerUpType::SHIELD:
-		// Shield - Blue/Purple
-		primaryColor[0] = 0.2f; primaryColor[1] = 0.4f; primaryColor[2] = 1.0f;
-		secondaryColor[0] = 0.6f; secondaryColor[1] = 0.2f; secondaryColor[2] = 0.9f;
-		accentColor[0] = 0.8f; accentColor[1] = 0.8f; accentColor[2] = 1.0f;
-		break;
-	}
 }
 
-void PowerUp::update(float deltaTime) {
+void PowerUpAnimation::update(PowerUp& powerUp, float deltaTime) {
+	bool isVisible = powerUp.getIsVisible(), isActive = powerUp.getIsActive();
 	if (!isVisible && !isActive) return;
 
 	animationTime += deltaTime;
@@ -36,7 +33,7 @@ void PowerUp::update(float deltaTime) {
 		// Countdown to disappear if not collected
 		remainingLife -= deltaTime;
 		if (remainingLife <= 0.0f) {
-			isVisible = false;
+			powerUp.remove();
 			return;
 		}
 	}
@@ -45,7 +42,7 @@ void PowerUp::update(float deltaTime) {
 		// Countdown active duration
 		duration -= deltaTime;
 		if (duration <= 0.0f) {
-			deactivate();
+			powerUp.deactivate();
 			return;
 		}
 	}
@@ -67,22 +64,24 @@ void PowerUp::update(float deltaTime) {
 	}
 }
 
-void PowerUp::render() {
-	if (!isVisible) return;
+void PowerUpAnimation::render(const PowerUp& powerUp) const {
+	if (!powerUp.getIsVisible()) return;
+	const float (*colors)[3] = Palette::get(material).colors;
+	float size = powerUp.getSize();
 
 	glPushMatrix();
-	glTranslatef(x, y, 0.0f);
+	glTranslatef(powerUp.getX(), powerUp.getY(), 0.0f);
 	glRotatef(rotationAngle, 0.0f, 0.0f, 1.0f);
 	glScalef(scaleAnimation, scaleAnimation, 1.0f);
 
 	float alpha = pulseAnimation;
 
-	switch (type) {
+	switch (powerUp.getType()) {
 	case PowerUpType::SPEED_BOOST:
 		{
 			// Lightning bolt design - 3 primitives
 			// 1. Main lightning body (triangles forming zigzag)
-			glColor3f(primaryColor[0] * alpha, primaryColor[1] * alpha, primaryColor[2] * alpha);
+			glColor3f(colors[PRIMARY_COLOR][0] * alpha, colors[PRIMARY_COLOR][1] * alpha, colors[PRIMARY_COLOR][2] * alpha);
 			float boltSize = size * 0.4f;
 			
 			// Top part of lightning
@@ -107,7 +106,7 @@ void PowerUp::render() {
 			glEnd();
 
 			// 2. Energy ring (circle)
-			glColor3f(secondaryColor[0] * alpha * 0.6f, secondaryColor[1] * alpha * 0.6f, secondaryColor[2] * alpha * 0.6f);
+			glColor3f(colors[SECONDARY_COLOR][0] * alpha * 0.6f, colors[SECONDARY_COLOR][1] * alpha * 0.6f, colors[SECONDARY_COLOR][2] * alpha * 0.6f);
 			glBegin(GL_TRIANGLE_FAN);
 			glVertex2f(0.0f, 0.0f);
 			for (int i = 0; i <= 16; i++) {
@@ -117,7 +116,7 @@ void PowerUp::render() {
 			glEnd();
 
 			// 3. Speed lines (quads)
-			glColor3f(accentColor[0] * alpha * 0.8f, accentColor[1] * alpha * 0.8f, accentColor[2] * alpha * 0.8f);
+			glColor3f(colors[ACCENT_COLOR][0] * alpha * 0.8f, colors[ACCENT_COLOR][1] * alpha * 0.8f, colors[ACCENT_COLOR][2] * alpha * 0.8f);
 			float lineWidth = size * 0.05f;
 			for (int i = 0; i < 4; i++) {
 				float angle = i * 90.0f;
@@ -138,7 +137,7 @@ void PowerUp::render() {
 		{
 			// Shield design - 3 primitives
 			// 1. Shield outline (hexagon using triangles)
-			glColor3f(primaryColor[0] * alpha, primaryColor[1] * alpha, primaryColor[2] * alpha);
+			glColor3f(colors[PRIMARY_COLOR][0] * alpha, colors[PRIMARY_COLOR][1] * alpha, colors[PRIMARY_COLOR][2] * alpha);
 			float shieldRadius = size * 0.5f;
 			glBegin(GL_TRIANGLE_FAN);
 			glVertex2f(0.0f, 0.0f);
@@ -149,7 +148,7 @@ void PowerUp::render() {
 			glEnd();
 
 			// 2. Inner shield (smaller hexagon)
-			glColor3f(secondaryColor[0] * alpha * 0.7f, secondaryColor[1] * alpha * 0.7f, secondaryColor[2] * alpha * 0.7f);
+			glColor3f(colors[SECONDARY_COLOR][0] * alpha * 0.7f, colors[SECONDARY_COLOR][1] * alpha * 0.7f, colors[SECONDARY_COLOR][2] * alpha * 0.7f);
 			glBegin(GL_TRIANGLE_FAN);
 			glVertex2f(0.0f, 0.0f);
 			for (int i = 0; i <= 6; i++) {
@@ -159,7 +158,7 @@ void PowerUp::render() {
 			glEnd();
 
 			// 3. Cross pattern (quads)
-			glColor3f(accentColor[0] * alpha, accentColor[1] * alpha, accentColor[2] * alpha);
+			glColor3f(colors[ACCENT_COLOR][0] * alpha, colors[ACCENT_COLOR][1] * alpha, colors[ACCENT_COLOR][2] * alpha);
 			float crossWidth = size * 0.08f;
 			float crossLength = size * 0.4f;
 			
@@ -185,8 +184,9 @@ void PowerUp::render() {
 	glPopMatrix();
 }
 
-void PowerUp::renderActiveEffect() {
-	if (!isActive) return;
+void PowerUpAnimation::renderActiveEffect(const PowerUp& powerUp) const {
+	if (!powerUp.getIsActive()) return;
+	const float (*colors)[3] = Palette::get(material).colors;
 
 	// Visual cue when power-up is active - glowing ring around player
 	glPushMatrix();
@@ -194,7 +194,7 @@ void PowerUp::renderActiveEffect() {
 	float effectRadius = 40.0f + 10.0f * sin(animationTime * 6.0f);
 	float effectAlpha = 0.3f + 0.2f * sin(animationTime * 8.0f);
 
-	glColor3f(primaryColor[0] * effectAlpha, primaryColor[1] * effectAlpha, primaryColor[2] * effectAlpha);
+	glColor3f(colors[PRIMARY_COLOR][0] * effectAlpha, colors[PRIMARY_COLOR][1] * effectAlpha, colors[PRIMARY_COLOR][2] * effectAlpha);
 	
 	// Outer ring
 	glBegin(GL_TRIANGLE_FAN);
@@ -223,9 +223,9 @@ void PowerUp::collect() {
 	activate();
 }
 
+// The effect timer is in PowerUpAnimation and starts full; a power-up is only ever collected once
 void PowerUp::activate() {
 	isActive = true;
-	duration = 8.0f;  
 }
 
 void PowerUp::deactivate() {
@@ -236,15 +236,6 @@ void PowerUp::remove() {
 	isVisible = false;
 }
 
-bool PowerUp::isColliding(float objX, float objY, float objRadius) const {
-	if (!isVisible) return false;
-
-	float dx = x - objX;
-	float dy = y - objY;
-	float distance = sqrt(dx * dx + dy * dy);
-	return distance < (size * 0.5f + objRadius);
-}
-
 void PowerUp::setPosition(float newX, float newY) {
 	x = newX;
 	y = newY;
@@ -1,5 +1,7 @@
 #pragma once
 #include <glut.h>
+#include "Palette.h"
+#include <cmath>
 
 enum class PowerUpType {
 	SPEED_BOOST,
@@ -7,6 +9,8 @@ enum class PowerUpType {
 	SHIELD
 };
 
+// Hot record: what the collision, lava and cleanup passes read. Timers and
+// animation live in PowerUpAnimation, a separate component of the same entity.
 class PowerUp {
 private:
 	// Position
@@ -16,20 +20,6 @@ private:
 	// Properties
 	PowerUpType type;
 	float size;
-	float duration;        // How long power-up lasts when active
-	float lifeTime;        // How long it stays on screen if not collected
-	float remainingLife;   // Time left before disappearing
-	
-	// Colors
-	float primaryColor[3];
-	float secondaryColor[3];
-	float accentColor[3];
-
-	// Animation
-	float rotationAngle;
-	float scaleAnimation;
-	float pulseAnimation;
-	float animationTime;
 	bool isVisible;
 	bool isActive;         // When collected and effect is active
 
@@ -37,11 +27,6 @@ public:
 	// Constructor
 	PowerUp(PowerUpType powerType, float startX, float startY, float powerSize = 25.0f);
 
-	// Update and render
-	void update(float deltaTime);
-	void render();
-	void renderActiveEffect();  // Visual cue when power-up is active
-
 	// Collection and activation
 	void collect();
 	void activate();
@@ -49,10 +34,16 @@ public:
 	void remove(); // hide without activating
 	bool getIsVisible() const { return isVisible; }
 	bool getIsActive() const { return isActive; }
-	float getRemainingDuration() const { return duration; }
 
-	// Collision detection
-	bool isColliding(float objX, float objY, float objRadius) const;
+	// Collision detection; inline so the collision passes don't make a call per entity
+	bool isColliding(float objX, float objY, float objRadius) const {
+		if (!isVisible) return false;
+
+		float dx = x - objX;
+		float dy = y - objY;
+		float distance = sqrt(dx * dx + dy * dy);
+		return distance < (size * 0.5f + objRadius);
+	}
 
 	// Getters
 	float getX() const { return x; }
@@ -63,3 +54,28 @@ public:
 	// Setters
 	void setPosition(float newX, float newY);
 };
+
+// Cold record: lifetime, effect timer and animation, touched by update and render only
+class PowerUpAnimation {
+private:
+	float duration;        // How long power-up lasts when active
+	float lifeTime;        // How long it stays on screen if not collected
+	float remainingLife;   // Time left before disappearing
+
+	// Animation
+	float rotationAngle;
+	float scaleAnimation;
+	float pulseAnimation;
+	float animationTime;
+	Material material;
+
+public:
+	explicit PowerUpAnimation(PowerUpType powerType);
+
+	// Update and render; update hides or deactivates the power-up when its timers run out
+	void update(PowerUp& powerUp, float deltaTime);
+	void render(const PowerUp& powerUp) const;
+	void renderActiveEffect(const PowerUp& powerUp) const;  // Visual cue when power-up is active
+
+	float getRemainingDuration() const { return duration; }
+};
@@ -0,0 +1,149 @@
+#include "Profiler.h"
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+	struct ZoneHistory {
+		const char* name;
+		float frameMs[Profiler::HISTORY_FRAMES];
+		float currentMs;
+		int filled;
+	};
+
+	std::mutex registryMutex;
+	std::vector<Profiler::ThreadBuffer*> registry;  // never shrinks; buffers live for the process
+
+	// Only touched from endFrame/getZoneStats, which run on the frame thread
+	ZoneHistory zones[Profiler::MAX_ZONES];
+	int zoneCount = 0;
+	int historyCursor = 0;
+	uint32_t nextThreadId = 1;
+
+	ZoneHistory* findZone(const char* name) {
+		for (int i = 0; i < zoneCount; ++i) {
+			if (zones[i].name == name) return &zones[i];
+		}
+		if (zoneCount == Profiler::MAX_ZONES) return nullptr;
+		ZoneHistory& zone = zones[zoneCount++];
+		zone.name = name;
+		zone.currentMs = 0.0f;
+		zone.filled = 0;
+		return &zone;
+	}
+
+	float percentile(const float* samples, int count, float p) {
+		float sorted[Profiler::HISTORY_FRAMES];
+		std::copy(samples, samples + count, sorted);
+		int k = (int)(p * (count - 1) + 0.5f);
+		std::nth_element(sorted, sorted + k, sorted + count);
+		return sorted[k];
+	}
+}
+
+uint64_t Profiler::now() {
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Profiler::ThreadBuffer& Profiler::threadBuffer() {
+	thread_local ThreadBuffer* buffer = nullptr;
+	if (!buffer) {
+		buffer = new ThreadBuffer();
+		buffer->head.store(0, std::memory_order_relaxed);
+		buffer->consumed = 0;
+		buffer->depth = 0;
+		std::lock_guard<std::mutex> lock(registryMutex);
+		buffer->threadId = nextThreadId++;
+		registry.push_back(buffer);
+	}
+	return *buffer;
+}
+
+void Profiler::record(const char* name, uint64_t startNs, uint64_t endNs, uint32_t depth) {
+	ThreadBuffer& buffer = threadBuffer();
+	uint32_t head = buffer.head.load(std::memory_order_relaxed);
+	ProfileEvent& e = buffer.events[head % RING_SIZE];
+	e.name = name;
+	e.startNs = startNs;
+	e.endNs = endNs;
+	e.depth = depth;
+	buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::endFrame() {
+	std::lock_guard<std::mutex> lock(registryMutex);
+	for (ThreadBuffer* buffer : registry) {
+		uint32_t head = buffer->head.load(std::memory_order_acquire);
+		// If the ring lapped us, only the newest RING_SIZE events are still there
+		if (head - buffer->consumed > (uint32_t)RING_SIZE) buffer->consumed = head - RING_SIZE;
+		for (uint32_t i = buffer->consumed; i != head; ++i) {
+			const ProfileEvent& e = buffer->events[i % RING_SIZE];
+			ZoneHistory* zone = findZone(e.name);
+			if (zone) zone->currentMs += (e.endNs - e.startNs) / 1.0e6f;
+		}
+		buffer->consumed = head;
+	}
+
+	for (int i = 0; i < zoneCount; ++i) {
+		zones[i].frameMs[historyCursor] = zones[i].currentMs;
+		zones[i].currentMs = 0.0f;
+		if (zones[i].filled < HISTORY_FRAMES) zones[i].filled++;
+	}
+	historyCursor = (historyCursor + 1) % HISTORY_FRAMES;
+}
+
+int Profiler::getZoneStats(ZoneStats* out, int maxZones) {
+	std::lock_guard<std::mutex> lock(registryMutex);
+	int count = std::min(zoneCount, maxZones);
+	for (int i = 0; i < count; ++i) {
+		out[i].name = zones[i].name;
+		if (zones[i].filled == 0) {
+			out[i].p50 = out[i].p99 = 0.0f;
+			continue;
+		}
+		// Until the window fills, the valid samples are the ones just before the cursor
+		const float* samples = zones[i].frameMs;
+		float recent[HISTORY_FRAMES];
+		if (zones[i].filled < HISTORY_FRAMES) {
+			for (int k = 0; k < zones[i].filled; ++k) {
+				recent[k] = samples[(historyCursor - 1 - k + HISTORY_FRAMES) % HISTORY_FRAMES];
+			}
+			samples = recent;
+		}
+		out[i].p50 = percentile(samples, zones[i].filled, 0.50f);
+		out[i].p99 = percentile(samples, zones[i].filled, 0.99f);
+	}
+	return count;
+}
+
+bool Profiler::exportChromeTrace(const char* path) {
+	FILE* out = fopen(path, "w");
+	if (!out) return false;
+
+	std::lock_guard<std::mutex> lock(registryMutex);
+	uint64_t origin = UINT64_MAX;
+	for (ThreadBuffer* buffer : registry) {
+		uint32_t head = buffer->head.load(std::memory_order_acquire);
+		uint32_t first = head > (uint32_t)RING_SIZE ? head - RING_SIZE : 0;
+		for (uint32_t i = first; i != head; ++i) origin = std::min(origin, buffer->events[i % RING_SIZE].startNs);
+	}
+
+	fprintf(out, "{\"traceEvents\":[\n");
+	bool firstEvent = true;
+	for (ThreadBuffer* buffer : registry) {
+		uint32_t head = buffer->head.load(std::memory_order_acquire);
+		uint32_t first = head > (uint32_t)RING_SIZE ? head - RING_SIZE : 0;
+		for (uint32_t i = first; i != head; ++i) {
+			const ProfileEvent& e = buffer->events[i % RING_SIZE];
+			fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				firstEvent ? "" : ",\n", e.name, buffer->threadId,
+				(e.startNs - origin) / 1000.0, (e.endNs - e.startNs) / 1000.0);
+			firstEvent = false;
+		}
+	}
+	fprintf(out, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	return fclose(out) == 0;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <atomic>
+
+// Scoped timing zones. PROFILE_ZONE compiles to nothing unless MOLTEN_PROFILE is set;
+// Debug builds turn it on, Release builds need /DMOLTEN_PROFILE=1.
+#if !defined(MOLTEN_PROFILE) && defined(_DEBUG)
+#define MOLTEN_PROFILE 1
+#endif
+
+struct ProfileEvent {
+	const char* name;   // must be a string literal; zones are keyed by pointer
+	uint64_t startNs;
+	uint64_t endNs;
+	uint32_t depth;
+};
+
+// Rolling per-zone frame times, in milliseconds
+struct ZoneStats {
+	const char* name;
+	float p50;
+	float p99;
+};
+
+class Profiler {
+public:
+	static const int RING_SIZE = 1 << 14;     // events kept per thread
+	static const int MAX_ZONES = 64;
+	static const int HISTORY_FRAMES = 240;    // window for the rolling percentiles
+
+	// One per thread that records zones; written only by its owner
+	struct ThreadBuffer {
+		ProfileEvent events[RING_SIZE];
+		std::atomic<uint32_t> head;  // total events ever written
+		uint32_t consumed;           // events already folded into zone stats
+		uint32_t threadId;
+		uint32_t depth;
+	};
+
+	static uint64_t now();
+	static ThreadBuffer& threadBuffer();
+	static void record(const char* name, uint64_t startNs, uint64_t endNs, uint32_t depth);
+
+	// Folds the events since the last call into per-zone frame totals; call once per frame
+	static void endFrame();
+
+	// Fills out with up to maxZones entries, ordered by first appearance; returns the count
+	static int getZoneStats(ZoneStats* out, int maxZones);
+
+	// Writes every event still held in the ring buffers as Chrome trace JSON (chrome://tracing, Perfetto)
+	static bool exportChromeTrace(const char* path);
+};
+
+class ProfileScope {
+private:
+	const char* name;
+	uint64_t start;
+	uint32_t depth;
+
+public:
+	explicit ProfileScope(const char* zoneName) : name(zoneName) {
+		Profiler::ThreadBuffer& buffer = Profiler::threadBuffer();
+		depth = buffer.depth++;
+		start = Profiler::now();
+	}
+	~ProfileScope() {
+		uint64_t end = Profiler::now();
+		Profiler::threadBuffer().depth--;
+		Profiler::record(name, start, end, depth);
+	}
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if MOLTEN_PROFILE
+#define PROFILE_ZONE(name) ProfileScope PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#endif
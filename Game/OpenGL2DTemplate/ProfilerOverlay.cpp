@@ -0,0 +1,108 @@
+#include "ProfilerOverlay.h"
+#include "Profiler.h"
+#include "GLStats.h"
+#include "AllocStats.h"
+#include <cstdio>
+
+ProfilerOverlay::ProfilerOverlay(float screenW, float screenH)
+	: screenWidth(screenW), screenHeight(screenH), isVisible(false)
+{
+	panelColor[0] = 0.0f; panelColor[1] = 0.0f; panelColor[2] = 0.0f;
+	textColor[0] = 0.6f; textColor[1] = 1.0f; textColor[2] = 0.6f;
+}
+
+void ProfilerOverlay::render() {
+	if (!isVisible) return;
+
+	ZoneStats stats[Profiler::MAX_ZONES];
+	int count = Profiler::getZoneStats(stats, Profiler::MAX_ZONES);
+
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	gluOrtho2D(0, screenWidth, 0, screenHeight);
+
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	const float lineHeight = 14.0f;
+	int lines = count + 1;
+#if MOLTEN_GL_STATS
+	lines += 2 + (int)GLStatCategory::Count;
+#endif
+#if MOLTEN_ALLOC_STATS
+	const int SHOWN_SITES = 4;
+	AllocSite sites[SHOWN_SITES];
+	int siteCount = AllocStats::getLastFrameSites(sites, SHOWN_SITES);
+	lines += 2 + (int)AllocCategory::Count + siteCount;
+#endif
+	float panelTop = screenHeight - 70.0f;
+	float panelBottom = panelTop - lineHeight * lines - 8.0f;
+	float panelLeft = 10.0f;
+	float panelRight = 400.0f;
+
+	glColor3fv(panelColor);
+	glBegin(GL_QUADS);
+	glVertex2f(panelLeft, panelBottom);
+	glVertex2f(panelRight, panelBottom);
+	glVertex2f(panelRight, panelTop);
+	glVertex2f(panelLeft, panelTop);
+	glEnd();
+
+	glColor3fv(textColor);
+	char line[96];
+	float y = panelTop - lineHeight;
+	renderLine("zone                          p50 ms   p99 ms", panelLeft + 6.0f, y);
+	for (int i = 0; i < count; ++i) {
+		y -= lineHeight;
+		snprintf(line, sizeof(line), "%-28.28s %7.3f  %7.3f", stats[i].name, stats[i].p50, stats[i].p99);
+		renderLine(line, panelLeft + 6.0f, y);
+	}
+
+#if MOLTEN_GL_STATS
+	// Last frame's GL traffic per entity type
+	y -= lineHeight * 2.0f;
+	renderLine("gl calls        prims    verts   matrix    state", panelLeft + 6.0f, y);
+	for (int i = 0; i < (int)GLStatCategory::Count; ++i) {
+		GLStatCategory category = (GLStatCategory)i;
+		const GLCounters& c = GLStats::getLastFrame(category);
+		y -= lineHeight;
+		snprintf(line, sizeof(line), "%-12s %8u %8u %8u %8u", GLStats::getCategoryName(category),
+			c.primitives, c.vertices, c.matrixOps, c.stateChanges);
+		renderLine(line, panelLeft + 6.0f, y);
+	}
+#endif
+
+#if MOLTEN_ALLOC_STATS
+	// Last frame's heap allocations per subsystem, then the busiest callers
+	y -= lineHeight * 2.0f;
+	renderLine("allocations     count      bytes", panelLeft + 6.0f, y);
+	for (int i = 0; i < (int)AllocCategory::Count; ++i) {
+		AllocCategory category = (AllocCategory)i;
+		const AllocCounters& c = AllocStats::getLastFrame(category);
+		y -= lineHeight;
+		snprintf(line, sizeof(line), "%-12s %8llu %10llu", AllocStats::getCategoryName(category),
+			(unsigned long long)c.count, (unsigned long long)c.bytes);
+		renderLine(line, panelLeft + 6.0f, y);
+	}
+	for (int i = 0; i < siteCount; ++i) {
+		y -= lineHeight;
+		snprintf(line, sizeof(line), "  at %-18p %6llu %10llu", sites[i].caller,
+			(unsigned long long)sites[i].count, (unsigned long long)sites[i].bytes);
+		renderLine(line, panelLeft + 6.0f, y);
+	}
+#endif
+
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPopMatrix();
+}
+
+void ProfilerOverlay::renderLine(const char* text, float x, float y) {
+	glRasterPos2f(x, y);
+	for (const char* c = text; *c; ++c) {
+		glutBitmapCharacter(GLUT_BITMAP_8_BY_13, *c);
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <glut.h>
+
+// Screen-space table of rolling p50/p99 per profiler zone
+class ProfilerOverlay {
+private:
+	float screenWidth;
+	float screenHeight;
+	bool isVisible;
+
+	float panelColor[3];
+	float textColor[3];
+
+public:
+	ProfilerOverlay(float screenW, float screenH);
+
+	void render();
+
+	void toggle() { isVisible = !isVisible; }
+	bool getIsVisible() const { return isVisible; }
+
+private:
+	void renderLine(const char* text, float x, float y);
+};
@@ -1,14 +1,14 @@
 #include "Rock.h"
+#include "GLStats.h"
+#include <vector>
 
 Rock::Rock(float startX, float startY, float width, float height) :
-	x(startX), y(startY), baseWidth(width), baseHeight(height), peakHeight(height * 0.3f)
+	x(startX), y(startY), baseWidth(width), baseHeight(height), peakHeight(height * 0.3f), material(Material::Rock)
 {
-	rockColor[0] = 0.5f;
-	rockColor[1] = 0.5f;
-	rockColor[2] = 0.5f;
 }
 
 void Rock::render() {
+	const float* rockColor = Palette::get(material).colors[0];
 	glPushMatrix();
 	glTranslatef(x, y, 0.0f);
 
@@ -32,6 +32,48 @@ void Rock::render() {
 	glPopMatrix();
 }
 
+void Rock::renderBatch(const Rock* rocks, size_t count, float bottom, float top) {
+	// Same shape as render(): base quad as two triangles plus the peak, 9 vertices per rock.
+	// Only the render thread draws, so the arrays are kept between frames.
+	static std::vector<GLfloat> positions;
+	static std::vector<GLfloat> colors;
+	positions.resize(count * 18);
+	colors.resize(count * 27);
+
+	GLsizei vertexCount = 0;
+	for (size_t i = 0; i < count; ++i) {
+		const Rock& r = rocks[i];
+		if (r.y > top || r.y + r.getHeight() < bottom) continue;
+
+		float left = r.x - r.baseWidth / 2, right = r.x + r.baseWidth / 2;
+		float base = r.y, shoulder = r.y + r.baseHeight, peak = shoulder + r.peakHeight;
+		const GLfloat shape[18] = {
+			left, base, right, base, right, shoulder,
+			left, base, right, shoulder, left, shoulder,
+			left, shoulder, right, shoulder, r.x, peak
+		};
+		GLfloat* p = &positions[vertexCount * 2];
+		GLfloat* c = &colors[vertexCount * 3];
+		for (int i = 0; i < 18; ++i) p[i] = shape[i];
+		const float* rockColor = Palette::get(r.material).colors[0];
+		for (int i = 0; i < 9; ++i) {
+			c[i * 3] = rockColor[0];
+			c[i * 3 + 1] = rockColor[1];
+			c[i * 3 + 2] = rockColor[2];
+		}
+		vertexCount += 9;
+	}
+	if (vertexCount == 0) return;
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, positions.data());
+	glColorPointer(3, GL_FLOAT, 0, colors.data());
+	glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+}
+
 void Rock::setPosition(float newX, float newY) {
 	x = newX;
 	y = newY;
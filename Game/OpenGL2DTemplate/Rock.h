@@ -1,5 +1,7 @@
 #pragma once
 #include <glut.h>
+#include <cstddef>
+#include "Palette.h"
 
 // will be a rectangle and on top of it semi-triangle to show irregular shape
 class Rock {
@@ -12,13 +14,16 @@ private:
 	float baseHeight;
 	float peakHeight;
 
-	float rockColor[3];
-	
+	Material material;
+
 public:
 	Rock(float startX, float startY, float width = 40.0f, float height = 30.0f);
 
 	void render();
 
+	// Draws every rock overlapping [bottom, top] with a single glDrawArrays call
+	static void renderBatch(const Rock* rocks, size_t count, float bottom, float top);
+
 	float getX() const { return x; }
 	float getY() const { return y; }
 	float getWidth() const {return baseWidth;}
@@ -0,0 +1,38 @@
+#include "SoundBank.h"
+#include "WavLoader.h"
+
+static const SoundInfo SOUNDS[(int)SoundId::Count] = {
+	{ "assets/sfx_collect.wav", 4, 2 },
+	{ "assets/sfx_hit.wav", 3, 1 },
+	{ "assets/sfx_key.wav", 1, 3 },
+	{ "assets/sfx_powerup.wav", 2, 2 },
+	{ "assets/sfx_win.wav", 1, 4 },
+	{ "assets/sfx_lose.wav", 1, 4 },
+};
+
+SoundBank::SoundBank() {
+	for (auto& s : sounds) s = { nullptr, 0, 1 };
+}
+
+const SoundInfo& SoundBank::getInfo(SoundId id) {
+	return SOUNDS[(int)id];
+}
+
+int SoundBank::load(int sampleRate) {
+	pcm.clear();
+	size_t offsets[(int)SoundId::Count];
+	int loaded = 0;
+
+	for (int i = 0; i < (int)SoundId::Count; ++i) {
+		offsets[i] = pcm.size();
+		sounds[i] = { nullptr, 0, 1 };
+		if (loadWav(SOUNDS[i].path, sampleRate, pcm, sounds[i].channels, sounds[i].frames)) ++loaded;
+	}
+
+	// Point the views into the block only once it has stopped growing
+	pcm.shrink_to_fit();
+	for (int i = 0; i < (int)SoundId::Count; ++i) {
+		sounds[i].samples = sounds[i].frames ? pcm.data() + offsets[i] : nullptr;
+	}
+	return loaded;
+}
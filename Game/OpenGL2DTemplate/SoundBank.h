@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+// Every sound effect the game can trigger; index into the bank
+enum class SoundId { Collect, Hit, Key, PowerUp, Win, Lose, Count };
+
+// A view of decoded interleaved 16-bit PCM at the mixer rate
+struct Sound {
+	const int16_t* samples;
+	uint32_t frames;
+	int channels;
+};
+
+// How a sound competes for mixer voices
+struct SoundInfo {
+	const char* path;
+	int maxVoices; // concurrent instances before the oldest one is restarted
+	int priority;  // higher may steal voices from lower when the pool is full
+};
+
+// All sound effects decoded once at startup into one contiguous PCM block
+class SoundBank {
+private:
+	std::vector<int16_t> pcm;
+	Sound sounds[(int)SoundId::Count];
+
+public:
+	SoundBank();
+
+	// Decodes every SoundId's file; missing files leave that sound empty. Returns the number loaded.
+	int load(int sampleRate);
+
+	// Empty sounds have zero frames
+	const Sound& get(SoundId id) const { return sounds[(int)id]; }
+
+	static const SoundInfo& getInfo(SoundId id);
+};
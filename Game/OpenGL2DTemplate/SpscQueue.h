@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// Fixed-capacity lock-free queue for exactly one producer thread and one consumer thread.
+// Capacity must be a power of two; one slot is kept free to tell full from empty.
+template <typename T, size_t Capacity>
+class SpscQueue {
+	static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+private:
+	T items[Capacity];
+	alignas(64) std::atomic<size_t> head;  // next slot to read, owned by the consumer
+	alignas(64) std::atomic<size_t> tail;  // next slot to write, owned by the producer
+
+public:
+	SpscQueue() : head(0), tail(0) {}
+
+	// Producer side; false if the queue is full
+	bool push(const T& item) {
+		size_t t = tail.load(std::memory_order_relaxed);
+		size_t next = (t + 1) & (Capacity - 1);
+		if (next == head.load(std::memory_order_acquire)) return false;
+		items[t] = item;
+		tail.store(next, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side; false if the queue is empty
+	bool pop(T& out) {
+		size_t h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire)) return false;
+		out = items[h];
+		head.store((h + 1) & (Capacity - 1), std::memory_order_release);
+		return true;
+	}
+};
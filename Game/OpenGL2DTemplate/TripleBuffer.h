@@ -0,0 +1,35 @@
+#pragma once
+#include <atomic>
+
+// Lock-free triple buffer for one writer thread and one reader thread. The
+// writer fills the back slot and publishes it; the reader takes the newest
+// published slot. Neither side ever waits, and the reader never sees a slot
+// that is still being written.
+template <typename T>
+class TripleBuffer {
+private:
+	static const int INDEX_MASK = 3;
+	static const int FRESH = 4; // set in middle while the reader has not taken it
+
+	T slots[3];
+	int back;                // owned by the writer
+	int front;               // owned by the reader
+	std::atomic<int> middle; // last published slot
+
+public:
+	explicit TripleBuffer(const T& initial) : slots{ initial, initial, initial }, back(0), front(1), middle(2) {}
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	// Writer side
+	T& getBack() { return slots[back]; }
+	void publish() { back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK; }
+
+	// Reader side; true if a newer slot was published since the last acquire
+	bool acquire() {
+		if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+		front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+	T& getFront() { return slots[front]; }
+};
@@ -0,0 +1,55 @@
+#include "Tuning.h"
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+
+struct TuningField {
+	const char* name;
+	size_t offset;
+};
+
+static const TuningField TUNING_FIELDS[] = {
+	{ "lava_speed", offsetof(Tuning, lavaSpeed) },
+	{ "lava_accel", offsetof(Tuning, lavaAccel) },
+	{ "rock_spawn_min", offsetof(Tuning, rockSpawnMin) },
+	{ "rock_spawn_max", offsetof(Tuning, rockSpawnMax) },
+	{ "rock_fall_speed", offsetof(Tuning, rockFallSpeed) },
+	{ "powerup_spawn_min", offsetof(Tuning, powerupSpawnMin) },
+	{ "powerup_spawn_max", offsetof(Tuning, powerupSpawnMax) },
+	{ "ability_duration", offsetof(Tuning, abilityDuration) },
+	{ "walk_speed", offsetof(Tuning, walkSpeed) },
+	{ "boost_speed", offsetof(Tuning, boostSpeed) },
+};
+
+bool setTuningValue(Tuning& tuning, const char* name, float value) {
+	for (const auto& field : TUNING_FIELDS) {
+		if (strcmp(field.name, name) == 0) {
+			*(float*)((char*)&tuning + field.offset) = value;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool loadTuningFile(const char* path, Tuning& tuning) {
+	FILE* in = fopen(path, "r");
+	if (!in) return false;
+
+	Tuning loaded = tuning;
+	char line[256];
+	bool ok = true;
+	while (ok && fgets(line, sizeof(line), in)) {
+		char* comment = strchr(line, '#');
+		if (comment) *comment = '\0';
+
+		char name[64];
+		float value;
+		int fields = sscanf(line, "%63s %f", name, &value);
+		if (fields <= 0) continue; // blank line
+		ok = fields == 2 && setTuningValue(loaded, name, value);
+	}
+	fclose(in);
+
+	if (ok) tuning = loaded;
+	return ok;
+}
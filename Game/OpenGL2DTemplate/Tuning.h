@@ -0,0 +1,29 @@
+#pragma once
+
+// Gameplay constants. Plain floats only: the struct is stored verbatim in binary level files.
+struct Tuning {
+	float lavaSpeed = 6.0f;         // initial growth rate
+	float lavaAccel = 0.3f;         // growth rate increase per second
+	float rockSpawnMin = 0.8f;      // seconds between rocks
+	float rockSpawnMax = 2.2f;
+	float rockFallSpeed = 120.0f;
+	float powerupSpawnMin = 8.0f;   // seconds between power-ups
+	float powerupSpawnMax = 14.0f;
+	float abilityDuration = 8.0f;
+	float walkSpeed = 200.0f;
+	float boostSpeed = 260.0f;      // walk speed while the speed power-up is active
+};
+
+// When the key appears and where it may be placed
+struct KeyRule {
+	int gemsRequired = 5;
+	float minY = 200.0f;
+	float lavaClearance = 80.0f;    // key spawns at least this far above the lava
+};
+
+// Sets the field with the given snake_case name (e.g. "lava_speed"); false if unknown
+bool setTuningValue(Tuning& tuning, const char* name, float value);
+
+// Reads "name value" lines ('#' comments) over the current values.
+// Nothing is applied unless every line parses, so a half-saved file leaves tuning untouched.
+bool loadTuningFile(const char* path, Tuning& tuning);
@@ -0,0 +1,65 @@
+#include "WavLoader.h"
+#include "MappedFile.h"
+#include <cstring>
+
+static uint32_t readU32(const unsigned char* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint16_t readU16(const unsigned char* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+bool parseWav(const unsigned char* bytes, size_t size, WavFormat& out) {
+	if (size < 12 || memcmp(bytes, "RIFF", 4) != 0 || memcmp(bytes + 8, "WAVE", 4) != 0) return false;
+
+	out.channels = 0;
+	out.sampleRate = 0;
+	out.bits = 0;
+	out.data = nullptr;
+	out.frames = 0;
+
+	size_t offset = 12;
+	uint32_t dataBytes = 0;
+	while (offset + 8 <= size) {
+		const unsigned char* chunk = bytes + offset;
+		uint32_t chunkSize = readU32(chunk + 4);
+		const unsigned char* body = chunk + 8;
+		size_t available = size - offset - 8;
+
+		if (memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && available >= 16) {
+			if (readU16(body) != 1) return false; // PCM only
+			out.channels = readU16(body + 2);
+			out.sampleRate = (int)readU32(body + 4);
+			out.bits = readU16(body + 14);
+		}
+		else if (memcmp(chunk, "data", 4) == 0) {
+			out.data = body;
+			dataBytes = chunkSize < available ? chunkSize : (uint32_t)available;
+			break;
+		}
+		offset += 8 + (size_t)chunkSize + (chunkSize & 1); // chunks are word aligned
+	}
+
+	if (out.channels < 1 || out.channels > 2 || out.sampleRate <= 0 || (out.bits != 8 && out.bits != 16) || !out.data) return false;
+	out.frames = dataBytes / (out.channels * out.bits / 8);
+	return out.frames > 0;
+}
+
+bool loadWav(const char* path, int sampleRate, std::vector<int16_t>& pcm, int& channels, uint32_t& frames) {
+	MappedFile file;
+	WavFormat format;
+	if (!file.open(path) || !parseWav(file.getData(), file.getSize(), format)) return false;
+
+	// Linear resample to the mixer rate
+	double step = (double)format.sampleRate / sampleRate;
+	channels = format.channels;
+	frames = (uint32_t)(format.frames / step);
+	size_t base = pcm.size();
+	pcm.resize(base + (size_t)frames * channels);
+	for (uint32_t i = 0; i < frames; ++i) {
+		double position = i * step;
+		uint32_t a = (uint32_t)position;
+		uint32_t b = a + 1 < format.frames ? a + 1 : a;
+		double t = position - a;
+		for (int c = 0; c < channels; ++c) {
+			pcm[base + (size_t)i * channels + c] = (int16_t)(wavSample(format, a, c) * (1.0 - t) + wavSample(format, b, c) * t);
+		}
+	}
+	return true;
+}
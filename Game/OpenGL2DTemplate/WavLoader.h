@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Uncompressed 8- or 16-bit PCM inside a WAV image; data points into the caller's bytes
+struct WavFormat {
+	int channels;
+	int sampleRate;
+	int bits;
+	const unsigned char* data;
+	uint32_t frames;
+};
+
+// Finds the fmt and data chunks without copying; false for anything but 1-2 channel 8/16-bit PCM
+bool parseWav(const unsigned char* bytes, size_t size, WavFormat& out);
+
+// One sample widened to the 16-bit range
+inline int wavSample(const WavFormat& format, uint32_t frame, int channel) {
+	size_t index = (size_t)frame * format.channels + channel;
+	if (format.bits == 8) return ((int)format.data[index] - 128) << 8;
+	const unsigned char* p = format.data + index * 2;
+	return (int16_t)(p[0] | (p[1] << 8));
+}
+
+// Decodes a whole WAV file resampled to sampleRate and appends it to pcm (interleaved)
+bool loadWav(const char* path, int sampleRate, std::vector<int16_t>& pcm, int& channels, uint32_t& frames);
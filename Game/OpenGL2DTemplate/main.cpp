@@ -1,32 +1,210 @@
 #include <glut.h>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "Game.h"
+#include "LevelFile.h"
+#include "Profiler.h"
+#include "ProfilerOverlay.h"
+#include "GLStats.h"
+#include "AllocStats.h"
+#include "JobSystem.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+
+static const int WINDOW_W = 800;
+static const int WINDOW_H = 600;
+static const int TICK_MS = 16;
+
+static Game* game = nullptr;
+static ProfilerOverlay* profilerOverlay = nullptr;
+static int lastTickTime = 0;
+
+// Pipelined mode: the simulation ticks on its own thread and hands each finished
+// tick to the GLUT thread as a snapshot, so tick N+1 runs while tick N is drawn.
+// Input is forwarded to the simulation thread through a queue.
+enum class InputType : unsigned char { KeyDown, KeyUp, SpecialDown, SpecialUp };
+struct InputEvent {
+	InputType type;
+	int key;
+};
+
+static bool pipelined = true;
+static TripleBuffer<RenderSnapshot>* snapshots = nullptr;
+static SpscQueue<InputEvent, 256> inputEvents;
+static std::thread* simThread = nullptr;
+static std::atomic<bool> simRunning(false);
+
+static void applyInput(const InputEvent& e) {
+	switch (e.type) {
+	case InputType::KeyDown: game->onKeyDown((unsigned char)e.key); break;
+	case InputType::KeyUp: game->onKeyUp((unsigned char)e.key); break;
+	case InputType::SpecialDown: game->onSpecialDown(e.key); break;
+	case InputType::SpecialUp: game->onSpecialUp(e.key); break;
+	}
+}
+
+static void sendInput(InputType type, int key) {
+	InputEvent e = { type, key };
+	if (pipelined) inputEvents.push(e);
+	else applyInput(e);
+}
+
+static void SimulationLoop() {
+	using clock = std::chrono::steady_clock;
+	auto last = clock::now();
+	auto next = last;
+	while (simRunning.load(std::memory_order_relaxed)) {
+		next += std::chrono::milliseconds(TICK_MS);
+		std::this_thread::sleep_until(next);
+
+		auto now = clock::now();
+		float dt = std::chrono::duration<float>(now - last).count();
+		last = now;
+		if (dt > 0.05f) {
+			dt = 0.05f; // don't tunnel through platforms after a stall
+			next = now; // and don't try to catch up on missed ticks
+		}
+
+		InputEvent e;
+		while (inputEvents.pop(e)) applyInput(e);
+		game->update(dt);
+		Audio::Flush();
+
+		game->captureSnapshot(snapshots->getBack());
+		snapshots->publish();
+	}
+}
+
+static void StopSimulation() {
+	simRunning = false;
+	if (simThread && simThread->joinable()) simThread->join();
+}
 
 void Display() {
 	glClear(GL_COLOR_BUFFER_BIT);
+	if (pipelined) Game::renderSnapshot(snapshots->getFront());
+	else game->render();
+	profilerOverlay->render();
+	glutSwapBuffers();
+	Profiler::endFrame();
+	GLStats::endFrame();
+	AllocStats::endFrame();
+}
 
-	glBegin(GL_TRIANGLES);
-		glColor3f(1.0f, 0.0f, 0.0f);
-		glVertex3f(150.0f, 200.0f, 0.0f);
-		glColor3f(0.0f, 1.0f, 0.0f);
-		glVertex3f(100.0f, 100.0f, 0.0f);
-		glColor3f(0.0f, 0.0f, 1.0f);
-		glVertex3f(200.0f, 100.0f, 0.0f);
-	glEnd();
+void Tick(int) {
+	int now = glutGet(GLUT_ELAPSED_TIME);
+	float dt = (now - lastTickTime) / 1000.0f;
+	lastTickTime = now;
+	if (dt > 0.05f) dt = 0.05f; // don't tunnel through platforms after a stall
+
+	game->update(dt);
+	Audio::Flush();
+	glutPostRedisplay();
+	glutTimerFunc(TICK_MS, Tick, 0);
+}
 
-	glFlush();
+// Polls faster than the tick rate so a new snapshot is drawn soon after it is published
+void RenderPoll(int) {
+	if (snapshots->acquire()) glutPostRedisplay();
+	glutTimerFunc(TICK_MS / 4, RenderPoll, 0);
 }
 
-void main(int argc, char** argr) {
-	glutInit(&argc, argr);
+void KeyDown(unsigned char key, int, int) { sendInput(InputType::KeyDown, key); }
+void KeyUp(unsigned char key, int, int) { sendInput(InputType::KeyUp, key); }
+void SpecialDown(int key, int, int) {
+	// F3 toggles the profiler overlay, F4 dumps the recorded zones for chrome://tracing
+	if (key == GLUT_KEY_F3) profilerOverlay->toggle();
+	else if (key == GLUT_KEY_F4) Profiler::exportChromeTrace("molten_trace.json");
+	else sendInput(InputType::SpecialDown, key);
+}
+void SpecialUp(int key, int, int) { sendInput(InputType::SpecialUp, key); }
+
+// Usage: MoltenAscent [--endless] [--seed N] [--level file.bin] [--tuning file.txt] [--audio-wav out.wav] [--no-pipeline]
+//                     [--rock-storm ROCKS_PER_SECOND] [--lava-flow]
+//        Level and tuning files are reloaded while the game runs whenever they are saved.
+//        --no-pipeline runs update and render one after the other on the GLUT thread.
+//        --lava-flow simulates the lava as a flowing grid instead of a rising sheet.
+//        --rock-storm is a stress mode; around 20000 keeps six figures of rocks in the air.
+//        MoltenAscent --convert-level level.txt level.bin
+int main(int argc, char** argv) {
+	if (argc == 4 && strcmp(argv[1], "--convert-level") == 0) {
+		char error[256];
+		if (!LevelFile::convertText(argv[2], argv[3], error, sizeof(error))) {
+			fprintf(stderr, "%s\n", error);
+			return 1;
+		}
+		return 0;
+	}
+
+	glutInit(&argc, argv);
 
-	glutInitWindowSize(300, 300);
+	GameMode mode = GameMode::Classic;
+	unsigned seed = 0;
+	const char* levelPath = nullptr;
+	const char* tuningPath = nullptr;
+	const char* audioWavPath = nullptr;
+	float rockStorm = 0.0f;
+	bool lavaFlow = false;
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--endless") == 0) mode = GameMode::Endless;
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = (unsigned)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) levelPath = argv[++i];
+		else if (strcmp(argv[i], "--tuning") == 0 && i + 1 < argc) tuningPath = argv[++i];
+		else if (strcmp(argv[i], "--audio-wav") == 0 && i + 1 < argc) audioWavPath = argv[++i];
+		else if (strcmp(argv[i], "--no-pipeline") == 0) pipelined = false;
+		else if (strcmp(argv[i], "--lava-flow") == 0) lavaFlow = true;
+		else if (strcmp(argv[i], "--rock-storm") == 0 && i + 1 < argc) rockStorm = (float)atof(argv[++i]);
+	}
+
+	glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
+	glutInitWindowSize(WINDOW_W, WINDOW_H);
 	glutInitWindowPosition(150, 150);
+	glutCreateWindow("Molten Ascent");
 
-	glutCreateWindow("OpenGL - 2D Template");
-	glutDisplayFunc(Display);
-	
-	glutInitDisplayMode(GLUT_SINGLE | GLUT_RGB);
 	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-	gluOrtho2D(0.0, 300, 0.0, 300);
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	gluOrtho2D(0.0, WINDOW_W, 0.0, WINDOW_H);
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+
+	// Fall back to a silent mixer if there is no usable device
+	if (audioWavPath) Audio::Init(AudioOutput::WavFile, audioWavPath);
+	else if (!Audio::Init(AudioOutput::Device)) Audio::Init(AudioOutput::None);
+	atexit(Audio::Shutdown);
+
+	// One worker per spare core for the parallel update passes
+	JobSystem::init();
+	atexit(JobSystem::shutdown);
+
+	game = new Game(WINDOW_W, WINDOW_H, 4, mode, seed);
+	if (levelPath && !game->loadLevel(levelPath)) return 1;
+	game->enableHotReload(tuningPath, levelPath);
+	game->setRockStorm(rockStorm);
+	game->setLavaFlow(lavaFlow);
+	profilerOverlay = new ProfilerOverlay((float)WINDOW_W, (float)WINDOW_H);
+
+	glutDisplayFunc(Display);
+	glutKeyboardFunc(KeyDown);
+	glutKeyboardUpFunc(KeyUp);
+	glutSpecialFunc(SpecialDown);
+	glutSpecialUpFunc(SpecialUp);
 
+	if (pipelined) {
+		snapshots = new TripleBuffer<RenderSnapshot>(game->snapshot());
+		simRunning = true;
+		simThread = new std::thread(SimulationLoop);
+		atexit(StopSimulation); // runs before Audio::Shutdown, which the simulation still calls into
+		glutTimerFunc(TICK_MS / 4, RenderPoll, 0);
+	}
+	else {
+		lastTickTime = glutGet(GLUT_ELAPSED_TIME);
+		glutTimerFunc(TICK_MS, Tick, 0);
+	}
 	glutMainLoop();
+	return 0;
 }
@@ -0,0 +1,115 @@
+// Mixer checks: each one records a short real-time run through WavFileAudioSink
+// and reads the last frame back. The test sounds are looping constants, so the
+// last frame does not depend on which buffer the mixer thread picked up a command.
+#include "TestCheck.h"
+#include "AudioMixer.h"
+#include "WavLoader.h"
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <cstdlib>
+
+static const char* const TEST_WAV = "audio-test.wav";
+static const int TEST_FRAMES = 64;
+
+// A mono sound holding one value, played looping so it sounds for the whole run
+struct ConstantSound {
+	int16_t samples[TEST_FRAMES];
+	Sound sound;
+
+	explicit ConstantSound(int16_t value) {
+		for (auto& s : samples) s = value;
+		sound = { samples, TEST_FRAMES, 1 };
+	}
+};
+
+struct StereoFrame {
+	int left;
+	int right;
+};
+
+// Starts a mixer on a WAV sink, lets play() queue commands, runs a few buffers
+// past them and returns the final frame of the recording
+template <typename Play>
+static StereoFrame recordLastFrame(Play play) {
+	StereoFrame last = { 0, 0 };
+	{
+		AudioMixer mixer;
+		if (!mixer.start(new WavFileAudioSink(TEST_WAV))) {
+			CHECK(!"could not open the test WAV");
+			return last;
+		}
+		play(mixer);
+		std::this_thread::sleep_for(std::chrono::milliseconds(150));
+		mixer.stop();
+	}
+
+	FILE* f = fopen(TEST_WAV, "rb");
+	std::vector<unsigned char> bytes;
+	if (f) {
+		fseek(f, 0, SEEK_END);
+		bytes.resize((size_t)ftell(f));
+		fseek(f, 0, SEEK_SET);
+		bytes.resize(fread(bytes.data(), 1, bytes.size(), f));
+		fclose(f);
+	}
+	remove(TEST_WAV);
+
+	WavFormat format;
+	bool parsed = parseWav(bytes.data(), bytes.size(), format);
+	CHECK(parsed && format.channels == 2 && format.frames > 0);
+	if (!parsed || format.channels != 2 || format.frames == 0) return last;
+	last.left = wavSample(format, format.frames - 1, 0);
+	last.right = wavSample(format, format.frames - 1, 1);
+	return last;
+}
+
+// Voices that overlap add up, and a centred voice plays at full gain
+static void overlappingVoicesSum() {
+	ConstantSound low(1000), high(2000);
+	StereoFrame f = recordLastFrame([&](AudioMixer& mixer) {
+		mixer.play(&low.sound, 1.0f, true, 0.0f, 1);
+		mixer.play(&high.sound, 1.0f, true, 0.0f, 2);
+	});
+	CHECK(f.left == 3000);
+	CHECK(f.right == 3000);
+}
+
+// Equal-power pan: hard left silences the right, and off-centre the near side stays at full gain
+static void equalPowerPan() {
+	ConstantSound tone(10000);
+	StereoFrame hardLeft = recordLastFrame([&](AudioMixer& mixer) { mixer.play(&tone.sound, 1.0f, true, -1.0f); });
+	CHECK(hardLeft.left == 10000);
+	CHECK(hardLeft.right == 0);
+
+	StereoFrame halfRight = recordLastFrame([&](AudioMixer& mixer) { mixer.play(&tone.sound, 1.0f, true, 0.5f); });
+	int expectedLeft = (int)(10000 * cosf(1.5f * 0.785398f) * 1.41421f); // cos(3pi/8) * sqrt(2)
+	CHECK(abs(halfRight.left - expectedLeft) <= 50);
+	CHECK(halfRight.right == 10000);
+}
+
+// A sound at its voice cap restarts its oldest instance; a full pool only gives way to a higher priority
+static void voiceCapStealing() {
+	ConstantSound a(100), b(1000), c(10000);
+	StereoFrame capped = recordLastFrame([&](AudioMixer& mixer) {
+		mixer.play(&a.sound, 1.0f, true, 0.0f, 1, 2);
+		mixer.play(&b.sound, 1.0f, true, 0.0f, 1, 2);
+		mixer.play(&c.sound, 1.0f, true, 0.0f, 1, 2); // replaces a
+	});
+	CHECK(capped.left == 11000);
+
+	ConstantSound quiet(10), loud(5000);
+	StereoFrame pool = recordLastFrame([&](AudioMixer& mixer) {
+		for (int i = 0; i < AudioMixer::MAX_VOICES; ++i) mixer.play(&quiet.sound, 1.0f, true, 0.0f, 1 + i, 1, 1);
+		mixer.play(&loud.sound, 1.0f, true, 0.0f, 100, 1, 0); // lower priority: refused
+		mixer.play(&loud.sound, 1.0f, true, 0.0f, 101, 1, 2); // higher priority: takes the oldest voice
+	});
+	CHECK(pool.left == 10 * (AudioMixer::MAX_VOICES - 1) + 5000);
+}
+
+void runAudioTests() {
+	overlappingVoicesSum();
+	equalPowerPan();
+	voiceCapStealing();
+}
@@ -0,0 +1,148 @@
+// game-tests: checks for gameplay and mixer rules that are easy to break while optimising.
+// Exits with status 1 and names the failing check if any does not hold.
+#include "TestCheck.h"
+#include "Game.h"
+#include <cmath>
+
+static const float TEST_DT = 1.0f / 60.0f;
+int testFailures = 0;
+
+struct GameTestAccess {
+	// Player standing at (x, y) with no ability running
+	static void placePlayer(Game& game, float x, float y) {
+		game.player.setPosition(x, y);
+		game.activeAbility = Ability::None;
+	}
+
+	static float playerCenterY(Game& game) { return game.player.getY() + game.player.getHeight() * 0.5f; }
+
+	static void detectAndResolve(Game& game) {
+		game.checkCollisions();
+		game.resolveEvents(TEST_DT);
+	}
+
+	// More gems on the player than the event queue holds must not push the lava kill out
+	static void lavaKillSurvivesFullQueue() {
+		Game game(800, 600, 4, GameMode::Classic, 1);
+		placePlayer(game, 400.0f, 200.0f);
+		game.lava.setHeight(game.player.getY() + 50.0f - game.lava.getY());
+		float cy = playerCenterY(game);
+		for (size_t i = 0; i < GameEventQueue::CAPACITY * 2; ++i) game.world.create(Collectable(400.0f, cy), CollectableAnimation());
+
+		detectAndResolve(game);
+		CHECK(game.events.size() == GameEventQueue::CAPACITY);
+		CHECK(game.state == GameState::Lost);
+	}
+
+	// A rock storm costs a life per rock but only one event
+	static void rockStormCountsEveryRock() {
+		Game game(800, 600, 4, GameMode::Classic, 1);
+		placePlayer(game, 400.0f, 300.0f);
+		game.lives = 5;
+		for (int i = 0; i < 3; ++i) game.world.create(Rock(390.0f, 300.0f, 40.0f, 28.0f));
+
+		detectAndResolve(game);
+		CHECK(game.events.size() == 1);
+		CHECK(game.lives == 2);
+		CHECK(game.state == GameState::Playing);
+
+		for (size_t i = 0; i < GameEventQueue::CAPACITY * 3; ++i) game.world.create(Rock(390.0f, 300.0f, 40.0f, 28.0f));
+		detectAndResolve(game);
+		CHECK(game.lives == 0);
+		CHECK(game.state == GameState::Lost);
+	}
+
+	// Events pushed out of order, some of them twice, sort by type then index and keep one of each
+	static void eventQueueSortsAndDropsRepeats() {
+		Game game(800, 600, 4, GameMode::Classic, 1);
+		Entity a = game.world.create(Collectable(100.0f, 100.0f), CollectableAnimation());
+		Entity b = game.world.create(Collectable(200.0f, 100.0f), CollectableAnimation());
+		Collectable* gemA = game.world.get<Collectable>(a);
+		Collectable* gemB = game.world.get<Collectable>(b);
+
+		GameEventQueue& q = game.events;
+		q.clear();
+		q.push(GameEventType::LavaKill, 0);
+		q.push(GameEventType::GemCollected, 7, gemB);
+		q.push(GameEventType::KeyCollected, 0);
+		q.push(GameEventType::GemCollected, 3, gemA);
+		q.push(GameEventType::GemCollected, 7, gemB);
+		q.push(GameEventType::LavaKill, 0);
+		q.sort();
+
+		CHECK(q.size() == 4);
+		if (q.size() != 4) return;
+		CHECK(q[0].type == GameEventType::GemCollected && q[0].order == 3 && q[0].getGem() == gemA);
+		CHECK(q[1].type == GameEventType::GemCollected && q[1].order == 7 && q[1].getGem() == gemB);
+		CHECK(q[2].type == GameEventType::KeyCollected);
+		CHECK(q[3].type == GameEventType::LavaKill);
+	}
+
+	// The key resolves before the door and the lava before both, whatever order detection pushed them in
+	static void resolveOrderFollowsEventType() {
+		Game won(800, 600, 4, GameMode::Classic, 1);
+		won.events.clear();
+		won.events.push(GameEventType::DoorReached, 0);
+		won.events.push(GameEventType::KeyCollected, 0);
+		won.resolveEvents(TEST_DT);
+		CHECK(won.hasKey);
+		CHECK(won.state == GameState::Won);
+
+		Game lost(800, 600, 4, GameMode::Classic, 1);
+		lost.events.clear();
+		lost.events.push(GameEventType::DoorReached, 0);
+		lost.events.push(GameEventType::KeyCollected, 0);
+		lost.events.push(GameEventType::LavaKill, 0);
+		lost.resolveEvents(TEST_DT);
+		CHECK(lost.hasKey);
+		CHECK(lost.state == GameState::Lost);
+	}
+
+	// A gem reported twice scores once, and one tick's sound requests merge into one per id
+	static void repeatsResolveOnceAndSoundsMerge() {
+		Game game(800, 600, 4, GameMode::Classic, 1);
+		Entity a = game.world.create(Collectable(0.0f, 100.0f), CollectableAnimation());
+		Entity b = game.world.create(Collectable(400.0f, 100.0f), CollectableAnimation());
+		Collectable* left = game.world.get<Collectable>(a);
+		Collectable* centre = game.world.get<Collectable>(b);
+		int score = game.score, collected = game.collectedCount;
+
+		game.events.clear();
+		game.events.push(GameEventType::GemCollected, 1, centre);
+		game.events.push(GameEventType::GemCollected, 0, left);
+		game.events.push(GameEventType::GemCollected, 1, centre);
+		game.resolveEvents(TEST_DT);
+
+		CHECK(game.score == score + 20);
+		CHECK(game.collectedCount == collected + 2);
+		int collects = game.sfxCount[(int)SoundId::Collect];
+		CHECK(collects == 2);
+		if (collects > 0) CHECK(fabsf(game.sfxPan[(int)SoundId::Collect] / collects + 0.5f) < 1e-4f); // mean of -1 and 0
+		CHECK(game.sfxCount[(int)SoundId::Hit] == 0);
+
+		// Nothing carries over into the next tick
+		game.events.clear();
+		game.resolveEvents(TEST_DT);
+		CHECK(game.sfxCount[(int)SoundId::Collect] == 0);
+	}
+};
+
+void runGameTests() {
+	GameTestAccess::lavaKillSurvivesFullQueue();
+	GameTestAccess::rockStormCountsEveryRock();
+	GameTestAccess::eventQueueSortsAndDropsRepeats();
+	GameTestAccess::resolveOrderFollowsEventType();
+	GameTestAccess::repeatsResolveOnceAndSoundsMerge();
+}
+
+int main() {
+	runGameTests();
+	runAudioTests();
+
+	if (testFailures > 0) {
+		fprintf(stderr, "%d check(s) failed\n", testFailures);
+		return 1;
+	}
+	printf("all checks passed\n");
+	return 0;
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstdio>
+
+// Shared by the test files; main in GameTests.cpp reports the total
+extern int testFailures;
+
+#define CHECK(cond) do { if (!(cond)) { fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); ++testFailures; } } while (0)
+
+void runGameTests();
+void runAudioTests();